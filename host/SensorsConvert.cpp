@@ -0,0 +1,379 @@
+//
+//  SensorsConvert
+//  Host C++ code
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <math.h>
+
+#include <SensorsConvert.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SENSORS_CONVERT_X86
+#include <immintrin.h>
+#endif
+
+// TSL2561 T, FN and CL package: up to ratio IR / full, lux is
+// full * B - IR * M. The integer table of the datasheet in floats.
+static const float luxRatio[SENSORS_LUX_SEGMENTS] = {
+    0x0040 / 512.0f, 0x0080 / 512.0f, 0x00C0 / 512.0f, 0x0100 / 512.0f,
+    0x0138 / 512.0f, 0x019A / 512.0f, 0x029A / 512.0f, 0x029A / 512.0f
+};
+static const float luxB[SENSORS_LUX_SEGMENTS] = {
+    0x01F2 / 16384.0f, 0x0214 / 16384.0f, 0x023F / 16384.0f, 0x0270 / 16384.0f,
+    0x016F / 16384.0f, 0x00D2 / 16384.0f, 0x0018 / 16384.0f, 0x0000 / 16384.0f
+};
+static const float luxM[SENSORS_LUX_SEGMENTS] = {
+    0x01BE / 16384.0f, 0x02D1 / 16384.0f, 0x037B / 16384.0f, 0x03FE / 16384.0f,
+    0x01FC / 16384.0f, 0x00FB / 16384.0f, 0x0012 / 16384.0f, 0x0000 / 16384.0f
+};
+
+// Scalar loops, also for the tail of the vector paths
+
+static void toFloatScalar(const int32_t *values, float *result, size_t start, size_t count)
+{
+    for (size_t i = start; i < count; i++) {
+        result[i] = (float)values[i] / SENSORS_FLOAT_TO_INT_MULTIPLY;
+    }
+}
+
+static void pressureScalar(const int32_t *pascal, float *result, size_t start, size_t count, float unit)
+{
+    for (size_t i = start; i < count; i++) {
+        result[i] = (float)pascal[i] * unit;
+    }
+}
+
+// NaN for a humidity of 0 or less
+static void dewPointScalar(const int32_t *temperature, const int32_t *humidity, float *result, size_t start, size_t count)
+{
+    for (size_t i = start; i < count; i++) {
+        float celsius = (float)temperature[i] / SENSORS_FLOAT_TO_INT_MULTIPLY;
+        float gamma = SENSORS_DEWPOINT_A * celsius / (SENSORS_DEWPOINT_B + celsius) + logf((float)humidity[i] / (SENSORS_FLOAT_TO_INT_MULTIPLY * 100.0f));
+        result[i] = SENSORS_DEWPOINT_B * gamma / (SENSORS_DEWPOINT_A - gamma);
+    }
+}
+
+// The ratio of a dark full channel is not a number, that takes the last
+// segment and gives 0
+static void luxScalar(const int32_t *full, const int32_t *ir, float *result, size_t start, size_t count, float scale)
+{
+    for (size_t i = start; i < count; i++) {
+        float ratio = (float)ir[i] / (float)full[i];
+        float b = 0.0f;
+        float m = 0.0f;
+        for (uint8_t segment = 0; segment < SENSORS_LUX_SEGMENTS; segment++) {
+            if (ratio <= luxRatio[segment]) {
+                b = luxB[segment];
+                m = luxM[segment];
+                break;
+            }
+        }
+        float lux = ((float)full[i] * b - (float)ir[i] * m) * (scale / SENSORS_FLOAT_TO_INT_MULTIPLY);
+        result[i] = lux > 0.0f ? lux : 0.0f;
+    }
+}
+
+#ifdef SENSORS_CONVERT_X86
+
+// Natural log as in Cephes logf, NaN for 0 and less
+static inline __m128 logSSE2(__m128 x)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 invalid = _mm_cmple_ps(x, _mm_setzero_ps());
+    x = _mm_max_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x00800000)));
+    __m128i bits = _mm_castps_si128(x);
+    __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0x7E)));
+    x = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F000000)));
+    // Mantissa in [sqrt(1/2), sqrt(2)) - 1
+    __m128 small = _mm_cmplt_ps(x, _mm_set1_ps(0.707106781186547524f));
+    e = _mm_sub_ps(e, _mm_and_ps(one, small));
+    x = _mm_add_ps(_mm_sub_ps(x, one), _mm_and_ps(x, small));
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(7.0376836292e-2f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+    y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    x = _mm_add_ps(_mm_add_ps(x, y), _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+    return _mm_or_ps(x, invalid);
+}
+
+static size_t toFloatSSE2(const int32_t *values, float *result, size_t count)
+{
+    const __m128 divisor = _mm_set1_ps(SENSORS_FLOAT_TO_INT_MULTIPLY);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 value = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(values + i)));
+        _mm_storeu_ps(result + i, _mm_div_ps(value, divisor));
+    }
+    return i;
+}
+
+static size_t pressureSSE2(const int32_t *pascal, float *result, size_t count, float unit)
+{
+    const __m128 factor = _mm_set1_ps(unit);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 value = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(pascal + i)));
+        _mm_storeu_ps(result + i, _mm_mul_ps(value, factor));
+    }
+    return i;
+}
+
+static size_t dewPointSSE2(const int32_t *temperature, const int32_t *humidity, float *result, size_t count)
+{
+    const __m128 divisor = _mm_set1_ps(SENSORS_FLOAT_TO_INT_MULTIPLY);
+    const __m128 percent = _mm_set1_ps(SENSORS_FLOAT_TO_INT_MULTIPLY * 100.0f);
+    const __m128 a = _mm_set1_ps(SENSORS_DEWPOINT_A);
+    const __m128 b = _mm_set1_ps(SENSORS_DEWPOINT_B);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 celsius = _mm_div_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(temperature + i))), divisor);
+        __m128 relative = _mm_div_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(humidity + i))), percent);
+        __m128 gamma = _mm_add_ps(_mm_div_ps(_mm_mul_ps(a, celsius), _mm_add_ps(b, celsius)), logSSE2(relative));
+        _mm_storeu_ps(result + i, _mm_div_ps(_mm_mul_ps(b, gamma), _mm_sub_ps(a, gamma)));
+    }
+    return i;
+}
+
+static inline __m128 selectSSE2(__m128 mask, __m128 chosen, __m128 other)
+{
+    return _mm_or_ps(_mm_and_ps(mask, chosen), _mm_andnot_ps(mask, other));
+}
+
+static size_t luxSSE2(const int32_t *full, const int32_t *ir, float *result, size_t count, float scale)
+{
+    const __m128 factor = _mm_set1_ps(scale / SENSORS_FLOAT_TO_INT_MULTIPLY);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 visible = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(full + i)));
+        __m128 infrared = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(ir + i)));
+        __m128 ratio = _mm_div_ps(infrared, visible);
+        __m128 b = _mm_setzero_ps();
+        __m128 m = _mm_setzero_ps();
+        // Downwards, so the first segment that holds the ratio wins
+        for (int8_t segment = SENSORS_LUX_SEGMENTS - 1; segment >= 0; segment--) {
+            __m128 inside = _mm_cmple_ps(ratio, _mm_set1_ps(luxRatio[segment]));
+            b = selectSSE2(inside, _mm_set1_ps(luxB[segment]), b);
+            m = selectSSE2(inside, _mm_set1_ps(luxM[segment]), m);
+        }
+        __m128 lux = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(visible, b), _mm_mul_ps(infrared, m)), factor);
+        _mm_storeu_ps(result + i, _mm_max_ps(lux, _mm_setzero_ps()));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static inline __m256 logAVX2(__m256 x)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 invalid = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LE_OQ);
+    x = _mm256_max_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x00800000)));
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0x7E)));
+    x = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000)));
+    __m256 small = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(one, small));
+    x = _mm256_add_ps(_mm256_sub_ps(x, one), _mm256_and_ps(x, small));
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+    y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+    x = _mm256_add_ps(_mm256_add_ps(x, y), _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+    return _mm256_or_ps(x, invalid);
+}
+
+__attribute__((target("avx2")))
+static size_t toFloatAVX2(const int32_t *values, float *result, size_t count)
+{
+    const __m256 divisor = _mm256_set1_ps(SENSORS_FLOAT_TO_INT_MULTIPLY);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(values + i)));
+        _mm256_storeu_ps(result + i, _mm256_div_ps(value, divisor));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t pressureAVX2(const int32_t *pascal, float *result, size_t count, float unit)
+{
+    const __m256 factor = _mm256_set1_ps(unit);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(pascal + i)));
+        _mm256_storeu_ps(result + i, _mm256_mul_ps(value, factor));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t dewPointAVX2(const int32_t *temperature, const int32_t *humidity, float *result, size_t count)
+{
+    const __m256 divisor = _mm256_set1_ps(SENSORS_FLOAT_TO_INT_MULTIPLY);
+    const __m256 percent = _mm256_set1_ps(SENSORS_FLOAT_TO_INT_MULTIPLY * 100.0f);
+    const __m256 a = _mm256_set1_ps(SENSORS_DEWPOINT_A);
+    const __m256 b = _mm256_set1_ps(SENSORS_DEWPOINT_B);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 celsius = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(temperature + i))), divisor);
+        __m256 relative = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(humidity + i))), percent);
+        __m256 gamma = _mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(a, celsius), _mm256_add_ps(b, celsius)), logAVX2(relative));
+        _mm256_storeu_ps(result + i, _mm256_div_ps(_mm256_mul_ps(b, gamma), _mm256_sub_ps(a, gamma)));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t luxAVX2(const int32_t *full, const int32_t *ir, float *result, size_t count, float scale)
+{
+    const __m256 factor = _mm256_set1_ps(scale / SENSORS_FLOAT_TO_INT_MULTIPLY);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 visible = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(full + i)));
+        __m256 infrared = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(ir + i)));
+        __m256 ratio = _mm256_div_ps(infrared, visible);
+        __m256 b = _mm256_setzero_ps();
+        __m256 m = _mm256_setzero_ps();
+        for (int8_t segment = SENSORS_LUX_SEGMENTS - 1; segment >= 0; segment--) {
+            __m256 inside = _mm256_cmp_ps(ratio, _mm256_set1_ps(luxRatio[segment]), _CMP_LE_OQ);
+            b = _mm256_blendv_ps(b, _mm256_set1_ps(luxB[segment]), inside);
+            m = _mm256_blendv_ps(m, _mm256_set1_ps(luxM[segment]), inside);
+        }
+        __m256 lux = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(visible, b), _mm256_mul_ps(infrared, m)), factor);
+        _mm256_storeu_ps(result + i, _mm256_max_ps(lux, _mm256_setzero_ps()));
+    }
+    return i;
+}
+
+#endif
+
+SensorsConvert::SensorsConvert()
+{
+    if (!setPath(SENSORS_CONVERT_AVX2)) {
+        setPath(SENSORS_CONVERT_SSE2);
+    }
+}
+
+// False, and the path unchanged, when the CPU cannot run it
+bool SensorsConvert::setPath(uint8_t path)
+{
+    if (!hasPath(path)) {
+        return false;
+    }
+    _path = path;
+    return true;
+}
+
+uint8_t SensorsConvert::getPath()
+{
+    return _path;
+}
+
+bool SensorsConvert::hasPath(uint8_t path)
+{
+    switch (path) {
+        case SENSORS_CONVERT_SCALAR:
+            return true;
+#ifdef SENSORS_CONVERT_X86
+        case SENSORS_CONVERT_SSE2:
+            return true;
+        case SENSORS_CONVERT_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+// Centi-units to units, divided as on the node
+void SensorsConvert::toFloat(const int32_t *values, float *result, size_t count)
+{
+    size_t done = 0;
+#ifdef SENSORS_CONVERT_X86
+    if (_path == SENSORS_CONVERT_AVX2) {
+        done = toFloatAVX2(values, result, count);
+    } else if (_path == SENSORS_CONVERT_SSE2) {
+        done = toFloatSSE2(values, result, count);
+    }
+#endif
+    toFloatScalar(values, result, done, count);
+}
+
+// Pa to SENSORS_PRESSURE_HPA, INHG or MMHG
+void SensorsConvert::pressure(const int32_t *pascal, float *result, size_t count, float unit)
+{
+    size_t done = 0;
+#ifdef SENSORS_CONVERT_X86
+    if (_path == SENSORS_CONVERT_AVX2) {
+        done = pressureAVX2(pascal, result, count, unit);
+    } else if (_path == SENSORS_CONVERT_SSE2) {
+        done = pressureSSE2(pascal, result, count, unit);
+    }
+#endif
+    pressureScalar(pascal, result, done, count, unit);
+}
+
+// C from centi C and centi %RH, NaN where the humidity is 0 or less
+void SensorsConvert::dewPoint(const int32_t *temperature, const int32_t *humidity, float *result, size_t count)
+{
+    size_t done = 0;
+#ifdef SENSORS_CONVERT_X86
+    if (_path == SENSORS_CONVERT_AVX2) {
+        done = dewPointAVX2(temperature, humidity, result, count);
+    } else if (_path == SENSORS_CONVERT_SSE2) {
+        done = dewPointSSE2(temperature, humidity, result, count);
+    }
+#endif
+    dewPointScalar(temperature, humidity, result, done, count);
+}
+
+// Lux from the full and IR records (centi counts). Without the integer
+// rounding of the driver, so within a lux or 1 % of calculateLux().
+void SensorsConvert::lux(const int32_t *full, const int32_t *ir, float *result, size_t count, float scale)
+{
+    size_t done = 0;
+#ifdef SENSORS_CONVERT_X86
+    if (_path == SENSORS_CONVERT_AVX2) {
+        done = luxAVX2(full, ir, result, count, scale);
+    } else if (_path == SENSORS_CONVERT_SSE2) {
+        done = luxSSE2(full, ir, result, count, scale);
+    }
+#endif
+    luxScalar(full, ir, result, done, count, scale);
+}
+
+// Times and values of one sensor out of decoded records, the arrays
+// these calls take. Returns the number of values.
+size_t SensorsConvert::gather(const SensorsRecord *records, size_t count, uint8_t sensor, int64_t *times, int32_t *values)
+{
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].sensor == sensor) {
+            times[found] = records[i].time;
+            values[found] = records[i].value;
+            found++;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,65 @@
+//
+//  SensorsConvert
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Batch conversions of decoded values, one array per quantity as
+//  SensorsStore::scan() returns them. Each call runs on the widest path
+//  of the CPU: AVX2 (8 values), SSE2 (4 values) or the scalar loop,
+//  which also takes the tail of every batch. Results of the paths agree
+//  to float rounding; the log in the dew point is a polynomial on the
+//  vector paths.
+//
+
+#ifndef SensorsConvert_h
+#define SensorsConvert_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <SensorsRecord.h>
+
+#define SENSORS_CONVERT_SCALAR          0
+#define SENSORS_CONVERT_SSE2            1
+#define SENSORS_CONVERT_AVX2            2
+
+// Pa to the unit
+#define SENSORS_PRESSURE_HPA            0.01f
+#define SENSORS_PRESSURE_INHG           2.952998e-4f
+#define SENSORS_PRESSURE_MMHG           7.500617e-3f
+
+// Dew point as Sensors_dewPointFast on the node
+#define SENSORS_DEWPOINT_A              17.271f
+#define SENSORS_DEWPOINT_B              237.7f
+
+// TSL2561 channel scale to 402 ms at 16x, times 16 at 1x gain. The node
+// runs at 13 ms and 16x.
+#define SENSORS_LUX_SCALE_13MS          (0x7517 / 1024.0f)
+#define SENSORS_LUX_SCALE_101MS         (0x0FE7 / 1024.0f)
+#define SENSORS_LUX_SCALE_402MS         1.0f
+#define SENSORS_LUX_SEGMENTS            8
+
+class SensorsConvert
+{
+public:
+    SensorsConvert();
+
+    bool setPath(uint8_t path);
+    uint8_t getPath();
+    static bool hasPath(uint8_t path);
+
+    void toFloat(const int32_t *values, float *result, size_t count);
+    void pressure(const int32_t *pascal, float *result, size_t count, float unit = SENSORS_PRESSURE_HPA);
+    void dewPoint(const int32_t *temperature, const int32_t *humidity, float *result, size_t count);
+    void lux(const int32_t *full, const int32_t *ir, float *result, size_t count, float scale = SENSORS_LUX_SCALE_13MS);
+
+    static size_t gather(const SensorsRecord *records, size_t count, uint8_t sensor, int64_t *times, int32_t *values);
+
+private:
+    uint8_t     _path       =   SENSORS_CONVERT_SCALAR;
+};
+
+#endif
@@ -0,0 +1,143 @@
+//
+//  SensorsConvertBench
+//  Host benchmark
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Converts the same arrays one value at a time in double, as a gateway
+//  does per record, and with SensorsConvert on each path this CPU has.
+//
+//  Usage: SensorsConvertBench [values] [rounds]
+//
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <SensorsConvert.h>
+
+static const char *paths[3] = { "scalar", "sse2", "avx2" };
+static SensorsConvert perRecord;
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// One record at a time, kept out of line as a per record call would be
+__attribute__((noinline)) static float perRecordFloat(int32_t value)
+{
+    return (double)value / SENSORS_FLOAT_TO_INT_MULTIPLY;
+}
+
+__attribute__((noinline)) static float perRecordPressure(int32_t pascal)
+{
+    return pascal * (double)SENSORS_PRESSURE_HPA;
+}
+
+__attribute__((noinline)) static float perRecordDewPoint(int32_t temperature, int32_t humidity)
+{
+    double celsius = (double)temperature / SENSORS_FLOAT_TO_INT_MULTIPLY;
+    double gamma = SENSORS_DEWPOINT_A * celsius / (SENSORS_DEWPOINT_B + celsius) + log(humidity * 0.0001);
+    return SENSORS_DEWPOINT_B * gamma / (SENSORS_DEWPOINT_A - gamma);
+}
+
+__attribute__((noinline)) static float perRecordLux(int32_t full, int32_t ir)
+{
+    float result;
+    perRecord.lux(&full, &ir, &result, 1);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? strtoul(argv[1], NULL, 0) : 1 << 20;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    std::vector<int32_t> temperature(count), humidity(count), pressure(count), full(count), ir(count);
+    std::vector<float> result(count);
+    perRecord.setPath(SENSORS_CONVERT_SCALAR);
+    srand(38);
+    for (size_t i = 0; i < count; i++) {
+        temperature[i] = rand() % 12500 - 4000;
+        humidity[i] = 1 + rand() % 10000;
+        pressure[i] = 80000 + rand() % 30000;
+        full[i] = (1 + rand() % 2000) * SENSORS_FLOAT_TO_INT_MULTIPLY;
+        ir[i] = rand() % full[i];
+    }
+    printf("%zu values, %d rounds, M values/s\n", count, rounds);
+    printf("%-10s %10s %10s %10s %10s\n", "", "float", "pressure", "dew point", "lux");
+
+    double rates[4];
+    float sink = 0.0f;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < count; i++) {
+            result[i] = perRecordFloat(temperature[i]);
+        }
+        sink += result[round % count];
+    }
+    rates[0] = count * (double)rounds / seconds(begin) / 1e6;
+    begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < count; i++) {
+            result[i] = perRecordPressure(pressure[i]);
+        }
+        sink += result[round % count];
+    }
+    rates[1] = count * (double)rounds / seconds(begin) / 1e6;
+    begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < count; i++) {
+            result[i] = perRecordDewPoint(temperature[i], humidity[i]);
+        }
+        sink += result[round % count];
+    }
+    rates[2] = count * (double)rounds / seconds(begin) / 1e6;
+    begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < count; i++) {
+            result[i] = perRecordLux(full[i], ir[i]);
+        }
+        sink += result[round % count];
+    }
+    rates[3] = count * (double)rounds / seconds(begin) / 1e6;
+    printf("%-10s %10.1f %10.1f %10.1f %10.1f\n", "record", rates[0], rates[1], rates[2], rates[3]);
+
+    for (uint8_t path = SENSORS_CONVERT_SCALAR; path <= SENSORS_CONVERT_AVX2; path++) {
+        SensorsConvert convert;
+        if (!convert.setPath(path)) {
+            continue;
+        }
+        begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            convert.toFloat(&temperature[0], &result[0], count);
+            sink += result[round % count];
+        }
+        rates[0] = count * (double)rounds / seconds(begin) / 1e6;
+        begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            convert.pressure(&pressure[0], &result[0], count);
+            sink += result[round % count];
+        }
+        rates[1] = count * (double)rounds / seconds(begin) / 1e6;
+        begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            convert.dewPoint(&temperature[0], &humidity[0], &result[0], count);
+            sink += result[round % count];
+        }
+        rates[2] = count * (double)rounds / seconds(begin) / 1e6;
+        begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            convert.lux(&full[0], &ir[0], &result[0], count);
+            sink += result[round % count];
+        }
+        rates[3] = count * (double)rounds / seconds(begin) / 1e6;
+        printf("%-10s %10.1f %10.1f %10.1f %10.1f\n", paths[path], rates[0], rates[1], rates[2], rates[3]);
+    }
+    // Keeps the loops from being dropped
+    return sink == 12345.0f ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+//
+//  SensorsFrame
+//  Host C++ code
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <string.h>
+
+#include <SensorsFrame.h>
+
+#define SENSORS_FRAME_START             0
+#define SENSORS_FRAME_LENGTH_HIGH       1
+#define SENSORS_FRAME_LENGTH_LOW        2
+#define SENSORS_FRAME_BODY              3
+#define SENSORS_FRAME_CHECKSUM          4
+
+SensorsFrameSplitter::SensorsFrameSplitter(uint8_t mode, uint64_t node)
+{
+    _mode = mode;
+    _node = node;
+}
+
+// True when value completed a payload, which is then in frame
+bool SensorsFrameSplitter::put(uint8_t value, int64_t arrival, SensorsFrame *frame)
+{
+    if (_mode == SENSORS_FRAME_RAW) {
+        return putRaw(value, arrival, frame);
+    }
+    return putApi(value, arrival, frame);
+}
+
+// At the end of the stream: the records collected so far in raw mode. A
+// frame cut off in API mode is counted as an error.
+bool SensorsFrameSplitter::flush(int64_t arrival, SensorsFrame *frame)
+{
+    if (_mode != SENSORS_FRAME_RAW) {
+        if (_state != SENSORS_FRAME_START) {
+            _errors++;
+            _state = SENSORS_FRAME_START;
+        }
+        return false;
+    }
+    uint16_t used = _need > 0 ? _start : _used;
+    if (_need > 0) {
+        _errors++;
+    }
+    _used = 0;
+    _need = 0;
+    return used > 0 && emit(_node, _data, used, arrival, frame);
+}
+
+uint64_t SensorsFrameSplitter::getFrames()
+{
+    return _frames;
+}
+
+// Bad sums, bad lengths, frames cut off by a new start and bytes that
+// start no known record
+uint64_t SensorsFrameSplitter::getErrors()
+{
+    return _errors;
+}
+
+// Frames of other types, such as AT responses and transmit status
+uint64_t SensorsFrameSplitter::getIgnored()
+{
+    return _ignored;
+}
+
+bool SensorsFrameSplitter::putApi(uint8_t value, int64_t arrival, SensorsFrame *frame)
+{
+    if (_mode == SENSORS_FRAME_API_ESCAPED) {
+        // A start delimiter is never data, it always begins a frame
+        if (value == XBEE_START_DELIMITER) {
+            if (_state != SENSORS_FRAME_START) {
+                _errors++;
+            }
+            _state = SENSORS_FRAME_LENGTH_HIGH;
+            _escape = false;
+            return false;
+        }
+        if (_state == SENSORS_FRAME_START) {
+            return false;
+        }
+        if (value == XBEE_ESCAPE) {
+            _escape = true;
+            return false;
+        }
+        if (_escape) {
+            value ^= XBEE_ESCAPE_XOR;
+            _escape = false;
+        }
+    } else if (_state == SENSORS_FRAME_START) {
+        if (value == XBEE_START_DELIMITER) {
+            _state = SENSORS_FRAME_LENGTH_HIGH;
+        }
+        return false;
+    }
+    switch (_state) {
+        case SENSORS_FRAME_LENGTH_HIGH:
+            _length = value << 8;
+            _state = SENSORS_FRAME_LENGTH_LOW;
+            break;
+        case SENSORS_FRAME_LENGTH_LOW:
+            _length |= value;
+            if (_length == 0 || _length > SENSORS_FRAME_API_SIZE) {
+                _errors++;
+                _state = SENSORS_FRAME_START;
+                break;
+            }
+            _used = 0;
+            _sum = 0;
+            _state = SENSORS_FRAME_BODY;
+            break;
+        case SENSORS_FRAME_BODY:
+            _data[_used++] = value;
+            _sum += value;
+            if (_used == _length) {
+                _state = SENSORS_FRAME_CHECKSUM;
+            }
+            break;
+        case SENSORS_FRAME_CHECKSUM:
+            _state = SENSORS_FRAME_START;
+            if ((uint8_t)(_sum + value) != 0xFF) {
+                _errors++;
+                break;
+            }
+            if (_data[0] == XBEE_RX_PACKET && _length > XBEE_RX_PACKET_HEADER) {
+                uint64_t node = 0;
+                for (uint8_t i = 1; i <= 8; i++) {
+                    node = (node << 8) | _data[i];
+                }
+                return emit(node, _data + XBEE_RX_PACKET_HEADER, _length - XBEE_RX_PACKET_HEADER, arrival, frame);
+            }
+            if (_data[0] == XBEE_TX_REQUEST && _length > XBEE_TX_REQUEST_HEADER) {
+                return emit(_node, _data + XBEE_TX_REQUEST_HEADER, _length - XBEE_TX_REQUEST_HEADER, arrival, frame);
+            }
+            _ignored++;
+            break;
+        default:
+            _state = SENSORS_FRAME_START;
+            break;
+    }
+    return false;
+}
+
+// Collects whole records, a sensor record needs its second byte to tell
+// its size
+bool SensorsFrameSplitter::putRaw(uint8_t value, int64_t arrival, SensorsFrame *frame)
+{
+    bool emitted = false;
+    if (_need == 0) {
+        switch (value) {
+            case XBEE_STALE_HEADER:
+                _need = 1;
+                break;
+            case XBEE_ALARM_HEADER:
+                _need = 3;
+                break;
+            case XBEE_TIME_HEADER:
+                _need = 1 + SENSORS_NODE_TIME_SIZE;
+                break;
+            case XBEE_SENSOR_HEADER:
+                _need = 2;
+                break;
+            default:
+                _errors++;
+                return false;
+        }
+        // A snapshot starts with a time record, after a stale one if any
+        bool start = value == XBEE_STALE_HEADER || value == XBEE_TIME_HEADER;
+        bool afterStale = value == XBEE_TIME_HEADER && _used == 1 && _data[0] == XBEE_STALE_HEADER;
+        if (_used > 0 && ((start && !afterStale) || _used + 2 + SENSORS_NODE_LONG_SIZE > SENSORS_FRAME_DATA)) {
+            emitted = emit(_node, _data, _used, arrival, frame);
+            _used = 0;
+        }
+        _start = _used;
+    }
+    _data[_used++] = value;
+    _need--;
+    if (_need == 0 && _data[_start] == XBEE_SENSOR_HEADER && _used - _start == 2) {
+        _need = sensorsValueSize(value);
+        if (_need == 0) {
+            _errors++;
+            _used = _start;
+        }
+    }
+    return emitted;
+}
+
+bool SensorsFrameSplitter::emit(uint64_t node, const uint8_t *data, uint16_t size, int64_t arrival, SensorsFrame *frame)
+{
+    if (size > SENSORS_FRAME_DATA) {
+        _errors++;
+        return false;
+    }
+    frame->node = node;
+    frame->arrival = arrival;
+    frame->size = size;
+    memcpy(frame->data, data, size);
+    _frames++;
+    return true;
+}
+
+static size_t putEscaped(uint8_t *data, uint8_t value)
+{
+    if (value == XBEE_START_DELIMITER || value == XBEE_ESCAPE || value == XBEE_XON || value == XBEE_XOFF) {
+        data[0] = XBEE_ESCAPE;
+        data[1] = value ^ XBEE_ESCAPE_XOR;
+        return 2;
+    }
+    data[0] = value;
+    return 1;
+}
+
+size_t sensorsPutFrame(uint8_t *data, uint64_t node, const uint8_t *payload, size_t size)
+{
+    uint8_t header[XBEE_RX_PACKET_HEADER];
+    header[0] = XBEE_RX_PACKET;
+    for (uint8_t i = 0; i < 8; i++) {
+        header[1 + i] = node >> ((7 - i) * 8);
+    }
+    header[9] = 0xFF;       // 16-bit address unknown
+    header[10] = 0xFE;
+    header[11] = 0x01;      // Acknowledged
+    size_t length = XBEE_RX_PACKET_HEADER + size;
+    size_t used = 0;
+    uint8_t sum = 0;
+    data[used++] = XBEE_START_DELIMITER;
+    used += putEscaped(data + used, length >> 8);
+    used += putEscaped(data + used, length & 0xFF);
+    for (uint8_t i = 0; i < XBEE_RX_PACKET_HEADER; i++) {
+        used += putEscaped(data + used, header[i]);
+        sum += header[i];
+    }
+    for (size_t i = 0; i < size; i++) {
+        used += putEscaped(data + used, payload[i]);
+        sum += payload[i];
+    }
+    used += putEscaped(data + used, 0xFF - sum);
+    return used;
+}
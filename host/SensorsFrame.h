@@ -0,0 +1,89 @@
+//
+//  SensorsFrame
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Cuts the byte stream of a coordinator into payloads for the decoder.
+//  In API mode (AP=1, or AP=2 with escaping) it checks length and sum
+//  of every frame and keeps the RF data of receive packets (0x90) with
+//  their 64-bit source address; transmit requests (0x10), as a node
+//  writes them with XBeeFrame, get the configured node. In raw mode the
+//  stream is putXBeeData() output without framing: it is cut in front of
+//  every time or stale record, where a snapshot starts.
+//
+
+#ifndef SensorsFrame_h
+#define SensorsFrame_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <SensorsRecord.h>
+
+#define SENSORS_FRAME_RAW               0
+#define SENSORS_FRAME_API               1
+#define SENSORS_FRAME_API_ESCAPED       2
+
+#define SENSORS_FRAME_DATA              240     // RF data of one payload
+#define SENSORS_FRAME_API_SIZE          (SENSORS_FRAME_DATA + 16)
+
+// Same as src/XBeeFrame.h
+#define XBEE_START_DELIMITER            0x7E
+#define XBEE_ESCAPE                     0x7D
+#define XBEE_XON                        0x11
+#define XBEE_XOFF                       0x13
+#define XBEE_ESCAPE_XOR                 0x20
+#define XBEE_TX_REQUEST                 0x10
+#define XBEE_RX_PACKET                  0x90
+#define XBEE_TX_REQUEST_HEADER          14      // Type, id, address 64 and 16, radius, options
+#define XBEE_RX_PACKET_HEADER           12      // Type, address 64 and 16, options
+
+struct SensorsFrame
+{
+    uint64_t    node;
+    int64_t     arrival;        // s
+    uint16_t    size;
+    uint8_t     data[SENSORS_FRAME_DATA];
+};
+
+class SensorsFrameSplitter
+{
+public:
+    SensorsFrameSplitter(uint8_t mode = SENSORS_FRAME_API_ESCAPED, uint64_t node = 0);
+
+    bool put(uint8_t value, int64_t arrival, SensorsFrame *frame);
+    bool flush(int64_t arrival, SensorsFrame *frame);
+
+    uint64_t getFrames();
+    uint64_t getErrors();
+    uint64_t getIgnored();
+
+private:
+    uint8_t     _mode;
+    uint64_t    _node;
+    uint8_t     _state          =   0;
+    bool        _escape         =   false;
+    uint16_t    _length         =   0;
+    uint16_t    _used           =   0;
+    uint8_t     _sum            =   0;
+    uint8_t     _data[SENSORS_FRAME_API_SIZE];
+    // Raw mode
+    uint8_t     _need           =   0;
+    uint16_t    _start          =   0;      // Of the record being collected
+    uint64_t    _frames         =   0;
+    uint64_t    _errors         =   0;
+    uint64_t    _ignored        =   0;
+
+    bool putApi(uint8_t value, int64_t arrival, SensorsFrame *frame);
+    bool putRaw(uint8_t value, int64_t arrival, SensorsFrame *frame);
+    bool emit(uint64_t node, const uint8_t *data, uint16_t size, int64_t arrival, SensorsFrame *frame);
+};
+
+// An escaped API receive packet around a payload, for replays, tests and
+// benchmarks. Returns the size, at most 2 * (size + 16).
+size_t sensorsPutFrame(uint8_t *data, uint64_t node, const uint8_t *payload, size_t size);
+
+#endif
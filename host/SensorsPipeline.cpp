@@ -0,0 +1,404 @@
+//
+//  SensorsPipeline
+//  Host C++ code
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <SensorsPipeline.h>
+
+#define SENSORS_PIPELINE_SPINS          64
+#define SENSORS_PIPELINE_SLEEP          50      // us, once spinning did not help
+
+static int64_t getMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Yields first, then sleeps so an idle serial port costs no core
+static void backoff(unsigned int *idle)
+{
+    if ((*idle)++ < SENSORS_PIPELINE_SPINS) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(SENSORS_PIPELINE_SLEEP));
+    }
+}
+
+static void raiseMaximum(std::atomic<size_t> *maximum, size_t value)
+{
+    size_t current = maximum->load(std::memory_order_relaxed);
+    while (value > current && !maximum->compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+static uint8_t getWorkers(uint8_t workers)
+{
+    if (workers < 1) {
+        return 1;
+    }
+    return workers > SENSORS_PIPELINE_WORKERS ? SENSORS_PIPELINE_WORKERS : workers;
+}
+
+// Addresses of one production run differ in the low bytes only
+static uint8_t getShard(uint64_t node, uint8_t workers)
+{
+    return ((node * 0x9E3779B97F4A7C15ULL) >> 32) % workers;
+}
+
+SensorsStoreSink::SensorsStoreSink(SensorsStore *store)
+{
+    _store = store;
+}
+
+void SensorsStoreSink::write(const SensorsRecord *records, size_t count)
+{
+    _store->append(records, count);
+}
+
+void SensorsStoreSink::flush()
+{
+    _store->flush();
+}
+
+SensorsRollupSink::SensorsRollupSink(SensorsRollup *rollup)
+{
+    _rollup = rollup;
+}
+
+void SensorsRollupSink::write(const SensorsRecord *records, size_t count)
+{
+    _rollup->update(records, count);
+}
+
+SensorsPipeline::SensorsPipeline(uint8_t workers, uint8_t mode, uint64_t node) :
+    _workerCount(getWorkers(workers)),
+    _workers(new SensorsWorker[_workerCount]),
+    _splitter(mode, node),
+    _batches(_workerCount * SENSORS_PIPELINE_BATCHES),
+    _free(_workerCount * SENSORS_PIPELINE_BATCHES),
+    _full(_workerCount * SENSORS_PIPELINE_BATCHES)
+{
+    for (size_t i = 0; i < _batches.size(); i++) {
+        _free.push(&_batches[i]);
+    }
+}
+
+SensorsPipeline::~SensorsPipeline()
+{
+    stop();
+    delete[] _workers;
+}
+
+// Sinks are only called from the sink thread, one batch at a time
+void SensorsPipeline::addSink(SensorsSink *sink)
+{
+    _sinks.push_back(sink);
+}
+
+// Runs until the end of the file, or until stop() for a serial port
+bool SensorsPipeline::start(int fd)
+{
+    if (_running.load() || _reader.joinable()) {
+        return false;
+    }
+    _fd = fd;
+    _stop.store(false);
+    _readerDone.store(false);
+    _decoding.store(_workerCount);
+    _running.store(true);
+    _started = getMicros();
+    for (uint8_t i = 0; i < _workerCount; i++) {
+        _workers[i].thread = std::thread(&SensorsPipeline::runWorker, this, &_workers[i]);
+    }
+    _sink = std::thread(&SensorsPipeline::runSink, this);
+    _reader = std::thread(&SensorsPipeline::runReader, this);
+    return true;
+}
+
+// The reader stops at its next read, what it read still goes through
+void SensorsPipeline::stop()
+{
+    _stop.store(true);
+    join();
+}
+
+void SensorsPipeline::join()
+{
+    if (_reader.joinable()) {
+        _reader.join();
+    }
+    for (uint8_t i = 0; i < _workerCount; i++) {
+        if (_workers[i].thread.joinable()) {
+            _workers[i].thread.join();
+        }
+    }
+    if (_sink.joinable()) {
+        _sink.join();
+    }
+}
+
+bool SensorsPipeline::isRunning()
+{
+    return _running.load();
+}
+
+// Safe while running. Depths are snapshots; the splitter reports the
+// deepest decoder queue it saw.
+SensorsPipelineMetrics SensorsPipeline::getMetrics()
+{
+    SensorsPipelineMetrics metrics;
+    int64_t end = _running.load() ? getMicros() : _stopped;
+    metrics.seconds = (end - _started) / 1e6;
+    for (uint8_t stage = 0; stage < SENSORS_STAGES; stage++) {
+        SensorsStageMetrics *metric = &metrics.stages[stage];
+        metric->items = _counters[stage].items.load(std::memory_order_relaxed);
+        metric->batches = _counters[stage].batches.load(std::memory_order_relaxed);
+        metric->stalls = _counters[stage].stalls.load(std::memory_order_relaxed);
+        metric->errors = _counters[stage].errors.load(std::memory_order_relaxed);
+        metric->depthMax = _counters[stage].depthMax.load(std::memory_order_relaxed);
+        metric->depth = 0;
+        metric->capacity = 0;
+    }
+    SensorsStageMetrics *splitter = &metrics.stages[SENSORS_STAGE_SPLITTER];
+    SensorsStageMetrics *decoder = &metrics.stages[SENSORS_STAGE_DECODER];
+    for (uint8_t i = 0; i < _workerCount; i++) {
+        splitter->depth += _workers[i].frames.getDepth();
+        splitter->capacity += _workers[i].frames.getCapacity();
+        decoder->items += _workers[i].counters.items.load(std::memory_order_relaxed);
+        decoder->batches += _workers[i].counters.batches.load(std::memory_order_relaxed);
+        decoder->stalls += _workers[i].counters.stalls.load(std::memory_order_relaxed);
+        decoder->errors += _workers[i].counters.errors.load(std::memory_order_relaxed);
+    }
+    decoder->depth = _full.getDepth();
+    decoder->capacity = _full.getCapacity();
+    return metrics;
+}
+
+// Raw 8N1 with a 100 ms read timeout, so the reader sees stop()
+int SensorsPipeline::openSerial(const char *path, unsigned long baud)
+{
+    speed_t speed;
+    switch (baud) {
+        case 9600:      speed = B9600;      break;
+        case 19200:     speed = B19200;     break;
+        case 38400:     speed = B38400;     break;
+        case 57600:     speed = B57600;     break;
+        case 115200:    speed = B115200;    break;
+        case 230400:    speed = B230400;    break;
+        default:        return -1;
+    }
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct termios options;
+    if (tcgetattr(fd, &options) != 0) {
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&options);
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 1;
+    if (tcsetattr(fd, TCSANOW, &options) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Payloads are gathered per decoder and sent once a batch is full or
+// the read is done, so a slow serial port does not hold them back
+void SensorsPipeline::runReader()
+{
+    std::vector<uint8_t> buffer(SENSORS_PIPELINE_READ);
+    std::vector<SensorsFrame> pending(_workerCount * SENSORS_PIPELINE_FRAME_BATCH);
+    std::vector<size_t> counts(_workerCount, 0);
+    SensorsFrame frame;
+    bool serial = isatty(_fd);
+    SensorsStageCounters *reader = &_counters[SENSORS_STAGE_READER];
+    SensorsStageCounters *splitter = &_counters[SENSORS_STAGE_SPLITTER];
+    while (!_stop.load(std::memory_order_relaxed)) {
+        ssize_t size = read(_fd, &buffer[0], buffer.size());
+        if (size < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            reader->errors.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        if (size == 0) {
+            if (serial) {
+                continue;
+            }
+            break;
+        }
+        reader->items.fetch_add(size, std::memory_order_relaxed);
+        reader->batches.fetch_add(1, std::memory_order_relaxed);
+        int64_t arrival = time(NULL);
+        for (ssize_t i = 0; i < size; i++) {
+            if (!_splitter.put(buffer[i], arrival, &frame)) {
+                continue;
+            }
+            uint8_t shard = getShard(frame.node, _workerCount);
+            pending[shard * SENSORS_PIPELINE_FRAME_BATCH + counts[shard]++] = frame;
+            if (counts[shard] == SENSORS_PIPELINE_FRAME_BATCH) {
+                send(shard, &pending[shard * SENSORS_PIPELINE_FRAME_BATCH], counts[shard]);
+                counts[shard] = 0;
+            }
+        }
+        for (uint8_t shard = 0; shard < _workerCount; shard++) {
+            if (counts[shard] > 0) {
+                send(shard, &pending[shard * SENSORS_PIPELINE_FRAME_BATCH], counts[shard]);
+                counts[shard] = 0;
+            }
+        }
+        splitter->items.store(_splitter.getFrames(), std::memory_order_relaxed);
+        splitter->errors.store(_splitter.getErrors(), std::memory_order_relaxed);
+    }
+    if (_splitter.flush(time(NULL), &frame)) {
+        send(getShard(frame.node, _workerCount), &frame, 1);
+    }
+    splitter->items.store(_splitter.getFrames(), std::memory_order_relaxed);
+    splitter->errors.store(_splitter.getErrors(), std::memory_order_relaxed);
+    _readerDone.store(true, std::memory_order_release);
+}
+
+void SensorsPipeline::send(uint8_t shard, SensorsFrame *frames, size_t count)
+{
+    SensorsWorker *worker = &_workers[shard];
+    SensorsStageCounters *splitter = &_counters[SENSORS_STAGE_SPLITTER];
+    size_t sent = 0;
+    unsigned int idle = 0;
+    while (true) {
+        sent += worker->frames.push(frames + sent, count - sent);
+        if (sent == count) {
+            break;
+        }
+        splitter->stalls.fetch_add(1, std::memory_order_relaxed);
+        backoff(&idle);
+    }
+    splitter->batches.fetch_add(1, std::memory_order_relaxed);
+    raiseMaximum(&splitter->depthMax, worker->frames.getDepth());
+}
+
+void SensorsPipeline::runWorker(SensorsWorker *worker)
+{
+    SensorsFrame frames[SENSORS_PIPELINE_FRAME_BATCH];
+    SensorsRecordBatch *batch = NULL;
+    SensorsStageCounters *decoder = &_counters[SENSORS_STAGE_DECODER];
+    unsigned int idle = 0;
+    while (true) {
+        size_t count = worker->frames.pop(frames, SENSORS_PIPELINE_FRAME_BATCH);
+        if (count == 0) {
+            if (_readerDone.load(std::memory_order_acquire) && worker->frames.getDepth() == 0) {
+                break;
+            }
+            backoff(&idle);
+            continue;
+        }
+        idle = 0;
+        uint64_t records = 0;
+        for (size_t i = 0; i < count; i++) {
+            const SensorsFrame *frame = &frames[i];
+            if (batch == NULL) {
+                batch = acquire(&worker->counters);
+            }
+            // A sensor record takes at least 4 bytes
+            if (SENSORS_PIPELINE_RECORDS - batch->count < frame->size / 4u + 1) {
+                while (!_full.push(batch)) {
+                    worker->counters.stalls.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+                raiseMaximum(&decoder->depthMax, _full.getDepth());
+                batch = acquire(&worker->counters);
+            }
+            size_t decoded = worker->decoder.decode(frame->node, frame->data, frame->size, frame->arrival, batch->records + batch->count, SENSORS_PIPELINE_RECORDS - batch->count);
+            batch->count += decoded;
+            records += decoded;
+        }
+        // Out of frames for now: what is decoded goes on, not waiting for a full batch
+        if (batch != NULL && batch->count > 0 && worker->frames.getDepth() == 0) {
+            while (!_full.push(batch)) {
+                worker->counters.stalls.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+            raiseMaximum(&decoder->depthMax, _full.getDepth());
+            batch = NULL;
+        }
+        worker->counters.items.fetch_add(records, std::memory_order_relaxed);
+        worker->counters.batches.fetch_add(1, std::memory_order_relaxed);
+        worker->counters.errors.store(worker->decoder.getMalformed() + worker->decoder.getTruncated(), std::memory_order_relaxed);
+    }
+    if (batch != NULL) {
+        if (batch->count > 0) {
+            while (!_full.push(batch)) {
+                std::this_thread::yield();
+            }
+        } else {
+            while (!_free.push(batch)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    _decoding.fetch_sub(1, std::memory_order_release);
+}
+
+void SensorsPipeline::runSink()
+{
+    SensorsStageCounters *sink = &_counters[SENSORS_STAGE_SINK];
+    unsigned int idle = 0;
+    while (true) {
+        SensorsRecordBatch *batch;
+        if (!_full.pop(&batch)) {
+            if (_decoding.load(std::memory_order_acquire) > 0) {
+                backoff(&idle);
+                continue;
+            }
+            // Every decoder is done, so this is the last look
+            if (!_full.pop(&batch)) {
+                break;
+            }
+        }
+        idle = 0;
+        for (size_t i = 0; i < _sinks.size(); i++) {
+            _sinks[i]->write(batch->records, batch->count);
+        }
+        sink->items.fetch_add(batch->count, std::memory_order_relaxed);
+        sink->batches.fetch_add(1, std::memory_order_relaxed);
+        batch->count = 0;
+        while (!_free.push(batch)) {
+            std::this_thread::yield();
+        }
+    }
+    for (size_t i = 0; i < _sinks.size(); i++) {
+        _sinks[i]->flush();
+    }
+    _stopped = getMicros();
+    _running.store(false);
+}
+
+// Waits while the sink holds every batch
+SensorsRecordBatch *SensorsPipeline::acquire(SensorsStageCounters *counters)
+{
+    SensorsRecordBatch *batch;
+    unsigned int idle = 0;
+    while (!_free.pop(&batch)) {
+        counters->stalls.fetch_add(1, std::memory_order_relaxed);
+        backoff(&idle);
+    }
+    batch->count = 0;
+    return batch;
+}
@@ -0,0 +1,163 @@
+//
+//  SensorsPipeline
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Gateway ingest in threads:
+//
+//      reader + splitter --SPSC per worker--> decoders --MPMC--> sinks
+//
+//  The reader cuts the stream of a file or serial port into payloads
+//  and hands them to the decoder of their node, so the records of one
+//  node stay in order. Decoders fill batches of records taken from a
+//  pool and queue them for the sink thread, which passes each batch to
+//  every sink and returns it to the pool. A full queue or an empty pool
+//  makes the stage in front wait: nothing is dropped, the waits are
+//  counted as stalls.
+//
+
+#ifndef SensorsPipeline_h
+#define SensorsPipeline_h
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include <SensorsFrame.h>
+#include <SensorsQueue.h>
+#include <SensorsRecord.h>
+#include <SensorsRollup.h>
+#include <SensorsStore.h>
+
+#define SENSORS_PIPELINE_WORKERS        32
+#define SENSORS_PIPELINE_READ           65536   // Bytes per read
+#define SENSORS_PIPELINE_FRAMES         1024    // Queue of each decoder
+#define SENSORS_PIPELINE_FRAME_BATCH    32
+#define SENSORS_PIPELINE_RECORDS        256     // Records per batch
+#define SENSORS_PIPELINE_BATCHES        8       // Pool per worker
+
+#define SENSORS_STAGE_READER            0       // Bytes
+#define SENSORS_STAGE_SPLITTER          1       // Payloads
+#define SENSORS_STAGE_DECODER           2       // Records
+#define SENSORS_STAGE_SINK              3       // Records
+#define SENSORS_STAGES                  4
+
+struct SensorsRecordBatch
+{
+    size_t          count;
+    SensorsRecord   records[SENSORS_PIPELINE_RECORDS];
+};
+
+class SensorsSink
+{
+public:
+    virtual ~SensorsSink() {}
+    virtual void write(const SensorsRecord *records, size_t count) = 0;
+    virtual void flush() {}
+};
+
+class SensorsStoreSink : public SensorsSink
+{
+public:
+    SensorsStoreSink(SensorsStore *store);
+    void write(const SensorsRecord *records, size_t count);
+    void flush();
+
+private:
+    SensorsStore    *_store;
+};
+
+class SensorsRollupSink : public SensorsSink
+{
+public:
+    SensorsRollupSink(SensorsRollup *rollup);
+    void write(const SensorsRecord *records, size_t count);
+
+private:
+    SensorsRollup   *_rollup;
+};
+
+// Counters of one stage; depth is of the queue behind it
+struct SensorsStageMetrics
+{
+    uint64_t    items;
+    uint64_t    batches;
+    uint64_t    stalls;         // Waits on a full queue or an empty pool
+    uint64_t    errors;
+    size_t      depth;
+    size_t      depthMax;
+    size_t      capacity;
+};
+
+struct SensorsPipelineMetrics
+{
+    double                  seconds;
+    SensorsStageMetrics     stages[SENSORS_STAGES];
+};
+
+struct SensorsStageCounters
+{
+    std::atomic<uint64_t>   items{0};
+    std::atomic<uint64_t>   batches{0};
+    std::atomic<uint64_t>   stalls{0};
+    std::atomic<uint64_t>   errors{0};
+    std::atomic<size_t>     depthMax{0};
+};
+
+struct SensorsWorker
+{
+    SensorsSpscQueue<SensorsFrame>  frames{SENSORS_PIPELINE_FRAMES};
+    SensorsDecoder                  decoder;
+    SensorsStageCounters            counters;
+    std::thread                     thread;
+};
+
+class SensorsPipeline
+{
+public:
+    SensorsPipeline(uint8_t workers, uint8_t mode = SENSORS_FRAME_API_ESCAPED, uint64_t node = 0);
+    ~SensorsPipeline();
+
+    void addSink(SensorsSink *sink);
+
+    bool start(int fd);
+    void stop();
+    void join();
+    bool isRunning();
+
+    SensorsPipelineMetrics getMetrics();
+
+    static int openSerial(const char *path, unsigned long baud);
+
+private:
+    uint8_t                                     _workerCount;
+    SensorsWorker                               *_workers;
+    SensorsFrameSplitter                        _splitter;
+    std::vector<SensorsSink *>                  _sinks;
+    std::vector<SensorsRecordBatch>             _batches;
+    SensorsMpmcQueue<SensorsRecordBatch *>      _free;
+    SensorsMpmcQueue<SensorsRecordBatch *>      _full;
+    SensorsStageCounters                        _counters[SENSORS_STAGES];
+    std::thread                                 _reader;
+    std::thread                                 _sink;
+    std::atomic<bool>                           _stop{false};
+    std::atomic<bool>                           _readerDone{false};
+    std::atomic<uint8_t>                        _decoding{0};
+    std::atomic<bool>                           _running{false};
+    int64_t                                     _started        =   0;
+    int64_t                                     _stopped        =   0;
+    int                                         _fd             =   -1;
+
+    void runReader();
+    void runWorker(SensorsWorker *worker);
+    void runSink();
+    void send(uint8_t shard, SensorsFrame *frames, size_t count);
+    SensorsRecordBatch *acquire(SensorsStageCounters *counters);
+};
+
+#endif
@@ -0,0 +1,179 @@
+//
+//  SensorsPipelineBench
+//  Host benchmark
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Writes the escaped API stream of a coordinator to a file, one receive
+//  packet every minute per node, and runs it through SensorsPipeline
+//  with 1 up to the given number of decoders: once into a sink that only
+//  counts, once into a SensorsStore and a SensorsRollup. Reports the
+//  rate and the metrics of every stage.
+//
+//  Usage: SensorsPipelineBench [payloads] [nodes] [workers]
+//
+
+#include <atomic>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <SensorsPipeline.h>
+
+#define BENCH_SENSORS   8
+
+static const uint8_t sensors[BENCH_SENSORS] = {
+    XBEE_TEMPERATURE_HEADER | 0x01, XBEE_TEMPERATURE_HEADER | 0x02, XBEE_HUMIDITY_HEADER | 0x01, XBEE_TEMPERATURE_HEADER | 0x03,
+    XBEE_LUX_HEADER | 0x02, XBEE_IR_HEADER | 0x02, XBEE_FULL_HEADER | 0x02, XBEE_PRESSURE_HEADER | 0x01
+};
+
+static const char *stages[SENSORS_STAGES] = { "reader", "splitter", "decoder", "sink" };
+
+class BenchSink : public SensorsSink
+{
+public:
+    void write(const SensorsRecord *records, size_t count)
+    {
+        _records += count;
+    }
+
+    uint64_t getRecords()
+    {
+        return _records;
+    }
+
+private:
+    uint64_t    _records        =   0;
+};
+
+static void removeDirectory(const std::string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            unlink((directory + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+static void printMetrics(const SensorsPipelineMetrics &metrics)
+{
+    for (uint8_t stage = 0; stage < SENSORS_STAGES; stage++) {
+        const SensorsStageMetrics *metric = &metrics.stages[stage];
+        printf("    %-8s %9.2f M/s %9llu batches %8llu stalls %6llu errors, depth %zu max %zu of %zu\n",
+               stages[stage], metric->items / metrics.seconds / 1e6, (unsigned long long)metric->batches,
+               (unsigned long long)metric->stalls, (unsigned long long)metric->errors,
+               metric->depth, metric->depthMax, metric->capacity);
+    }
+}
+
+static bool run(const char *path, uint8_t workers, SensorsSink **sinks, size_t count, SensorsPipelineMetrics *metrics)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    SensorsPipeline pipeline(workers);
+    for (size_t i = 0; i < count; i++) {
+        pipeline.addSink(sinks[i]);
+    }
+    pipeline.start(fd);
+    pipeline.join();
+    *metrics = pipeline.getMetrics();
+    close(fd);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t payloads = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    size_t nodes = argc > 2 ? strtoul(argv[2], NULL, 0) : 1000;
+    size_t workers = argc > 3 ? strtoul(argv[3], NULL, 0) : 4;
+    char file[] = "/tmp/SensorsPipelineBench-XXXXXX";
+    int fd = mkstemp(file);
+    if (fd < 0) {
+        printf("Cannot create %s\n", file);
+        return EXIT_FAILURE;
+    }
+
+    // Slow random walks, as in SensorsStoreBench
+    srand(26);
+    std::vector<uint8_t> stream;
+    std::vector<int32_t> levels(nodes * BENCH_SENSORS);
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i] = sensors[i % BENCH_SENSORS] == (XBEE_PRESSURE_HEADER | 0x01) ? 101325 : 2000;
+    }
+    stream.reserve(payloads * 64);
+    uint32_t start = 1571443200;
+    uint64_t expected = 0;
+    for (size_t i = 0; i < payloads; i++) {
+        uint64_t node = 0x0013A20040000000ULL + i % nodes;
+        uint32_t time = start + (i / nodes) * 60;
+        uint8_t payload[64];
+        size_t size = sensorsPutTime(payload, time);
+        for (uint8_t s = 0; s < BENCH_SENSORS; s++) {
+            int32_t *level = &levels[(i % nodes) * BENCH_SENSORS + s];
+            int change = rand() % 8;
+            *level += change == 0 ? -1 : (change == 1 ? 1 : 0);
+            size += sensorsPutValue(payload + size, sensors[s], *level);
+        }
+        uint8_t frame[2 * (64 + 16)];
+        size_t length = sensorsPutFrame(frame, node, payload, size);
+        stream.insert(stream.end(), frame, frame + length);
+        expected += BENCH_SENSORS;
+    }
+    if (write(fd, &stream[0], stream.size()) != (ssize_t)stream.size()) {
+        printf("Cannot write %s\n", file);
+        close(fd);
+        unlink(file);
+        return EXIT_FAILURE;
+    }
+    close(fd);
+    printf("%zu payloads, %zu nodes, %zu bytes\n", payloads, nodes, stream.size());
+
+    bool ok = true;
+    SensorsPipelineMetrics metrics;
+    for (size_t count = 1; count <= workers; count *= 2) {
+        BenchSink counter;
+        SensorsSink *sinks[1] = { &counter };
+        run(file, count, sinks, 1, &metrics);
+        printf("%zu decoders, count   %8.2f M records/s\n", count, counter.getRecords() / metrics.seconds / 1e6);
+        printMetrics(metrics);
+        ok = ok && counter.getRecords() == expected;
+    }
+
+    char temporary[] = "/tmp/SensorsPipelineBench-XXXXXX";
+    std::string directory = mkdtemp(temporary);
+    SensorsStore store;
+    SensorsRollup rollup;
+    if (!store.open(directory.c_str())) {
+        printf("Cannot open %s\n", directory.c_str());
+        unlink(file);
+        return EXIT_FAILURE;
+    }
+    SensorsStoreSink storeSink(&store);
+    SensorsRollupSink rollupSink(&rollup);
+    SensorsSink *sinks[2] = { &storeSink, &rollupSink };
+    run(file, workers, sinks, 2, &metrics);
+    printf("%zu decoders, store   %8.2f M records/s, %.2f bytes/point\n", workers,
+           store.getPoints() / metrics.seconds / 1e6, (double)store.getBytes() / store.getPoints());
+    printMetrics(metrics);
+    ok = ok && store.getPoints() == expected;
+
+    store.close();
+    removeDirectory(directory);
+    unlink(file);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
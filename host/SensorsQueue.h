@@ -0,0 +1,198 @@
+//
+//  SensorsQueue
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Bounded lock-free rings between the stages of SensorsPipeline.
+//  SensorsSpscQueue has one producer and one consumer thread and moves
+//  items in batches; each side keeps a copy of the other side's index
+//  and only reads the shared one when the copy says full or empty.
+//  SensorsMpmcQueue takes any number of threads on both sides, each
+//  cell carries a sequence number (Vyukov). Neither ever blocks: a push
+//  to a full queue returns what it took, the caller decides to wait.
+//
+
+#ifndef SensorsQueue_h
+#define SensorsQueue_h
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define SENSORS_QUEUE_LINE      64      // Padding, not alignas: new ignores it before C++17
+
+static inline size_t sensorsQueueCapacity(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    return size;
+}
+
+template <class T>
+class SensorsSpscQueue
+{
+public:
+    // Rounded up to a power of 2
+    explicit SensorsSpscQueue(size_t capacity) :
+        _items(sensorsQueueCapacity(capacity)),
+        _mask(_items.size() - 1)
+    {
+    }
+
+    // Producer only, returns the number of items taken
+    size_t push(const T *items, size_t count)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t free = _items.size() - (tail - _headCache);
+        if (free < count) {
+            _headCache = _head.load(std::memory_order_acquire);
+            free = _items.size() - (tail - _headCache);
+        }
+        if (count > free) {
+            count = free;
+        }
+        for (size_t i = 0; i < count; i++) {
+            _items[(tail + i) & _mask] = items[i];
+        }
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer only, returns the number of items taken
+    size_t pop(T *items, size_t count)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t available = _tailCache - head;
+        if (available < count) {
+            _tailCache = _tail.load(std::memory_order_acquire);
+            available = _tailCache - head;
+        }
+        if (count > available) {
+            count = available;
+        }
+        for (size_t i = 0; i < count; i++) {
+            items[i] = _items[(head + i) & _mask];
+        }
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Exact from either side, a snapshot from any other thread
+    size_t getDepth() const
+    {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    size_t getCapacity() const
+    {
+        return _items.size();
+    }
+
+private:
+    std::vector<T>          _items;
+    size_t                  _mask;
+    uint8_t                 _line1[SENSORS_QUEUE_LINE];
+    std::atomic<size_t>     _head{0};
+    size_t                  _tailCache  =   0;
+    uint8_t                 _line2[SENSORS_QUEUE_LINE];
+    std::atomic<size_t>     _tail{0};
+    size_t                  _headCache  =   0;
+    uint8_t                 _line3[SENSORS_QUEUE_LINE];
+};
+
+template <class T>
+class SensorsMpmcQueue
+{
+public:
+    // Rounded up to a power of 2
+    explicit SensorsMpmcQueue(size_t capacity) :
+        _cells(sensorsQueueCapacity(capacity)),
+        _mask(_cells.size() - 1)
+    {
+        for (size_t i = 0; i < _cells.size(); i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T &item)
+    {
+        size_t position = _enqueue.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &_cells[position & _mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0) {
+                if (_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _enqueue.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T *item)
+    {
+        size_t position = _dequeue.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &_cells[position & _mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+            if (difference == 0) {
+                if (_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _dequeue.load(std::memory_order_relaxed);
+            }
+        }
+        *item = cell->item;
+        cell->sequence.store(position + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // A snapshot, pushes and pops in flight may be counted or not
+    size_t getDepth() const
+    {
+        size_t enqueue = _enqueue.load(std::memory_order_acquire);
+        size_t dequeue = _dequeue.load(std::memory_order_acquire);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    size_t getCapacity() const
+    {
+        return _cells.size();
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t>     sequence;
+        T                       item;
+    };
+
+    std::vector<Cell>       _cells;
+    size_t                  _mask;
+    uint8_t                 _line1[SENSORS_QUEUE_LINE];
+    std::atomic<size_t>     _enqueue{0};
+    uint8_t                 _line2[SENSORS_QUEUE_LINE];
+    std::atomic<size_t>     _dequeue{0};
+    uint8_t                 _line3[SENSORS_QUEUE_LINE];
+};
+
+#endif
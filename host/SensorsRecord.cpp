@@ -0,0 +1,155 @@
+//
+//  SensorsRecord
+//  Host C++ code
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <SensorsRecord.h>
+
+// Each type has one value size, see putXBeeInt() and putXBeeLong()
+uint8_t sensorsValueSize(uint8_t sensor)
+{
+    switch (sensor & 0xF8) {
+        case XBEE_TEMPERATURE_HEADER:
+        case XBEE_HUMIDITY_HEADER:
+        case XBEE_DEWPOINT_HEADER:
+            return SENSORS_NODE_INT_SIZE;
+        case XBEE_LUX_HEADER:
+        case XBEE_IR_HEADER:
+        case XBEE_VISIBLE_HEADER:
+        case XBEE_FULL_HEADER:
+        case XBEE_PRESSURE_HEADER:
+        case XBEE_ALTITUDE_HEADER:
+            return SENSORS_NODE_LONG_SIZE;
+        default:
+            return 0;
+    }
+}
+
+static uint32_t getBigEndian(const uint8_t *data, uint8_t size)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+// Stops at the first record it does not know or that is cut off, the
+// records before it are kept. A sensor record takes at least 4 bytes, so
+// size / 4 records always fit.
+size_t SensorsDecoder::decode(uint64_t node, const uint8_t *data, size_t size, int64_t arrival, SensorsRecord *records, size_t capacity)
+{
+    size_t count = 0;
+    size_t position = 0;
+    int64_t time = arrival;
+    uint8_t flags = SENSORS_RECORD_ARRIVAL;
+    uint8_t alarm = 0;
+    uint8_t channel = 0;
+    _payloads++;
+    while (position < size && count < capacity) {
+        uint8_t header = data[position];
+        if (header == XBEE_STALE_HEADER) {
+            flags |= SENSORS_RECORD_STALE;
+            position++;
+        } else if (header == XBEE_ALARM_HEADER) {
+            if (position + 3 > size) {
+                _truncated++;
+                break;
+            }
+            channel = data[position + 1];
+            alarm = data[position + 2];
+            flags |= SENSORS_RECORD_ALARM;
+            position += 3;
+        } else if (header == XBEE_TIME_HEADER) {
+            if (position + 1 + SENSORS_NODE_TIME_SIZE > size) {
+                _truncated++;
+                break;
+            }
+            time = getBigEndian(data + position + 1, SENSORS_NODE_TIME_SIZE);
+            flags &= ~SENSORS_RECORD_ARRIVAL;
+            position += 1 + SENSORS_NODE_TIME_SIZE;
+        } else if (header == XBEE_SENSOR_HEADER) {
+            if (position + 2 > size) {
+                _truncated++;
+                break;
+            }
+            uint8_t sensor = data[position + 1];
+            uint8_t length = sensorsValueSize(sensor);
+            if (length == 0) {
+                _malformed++;
+                break;
+            }
+            if (position + 2 + length > size) {
+                _truncated++;
+                break;
+            }
+            uint32_t raw = getBigEndian(data + position + 2, length);
+            SensorsRecord *record = &records[count++];
+            record->node = node;
+            record->time = time;
+            record->value = length == SENSORS_NODE_INT_SIZE ? (int32_t)(int16_t)raw : (int32_t)raw;
+            record->sensor = sensor;
+            record->flags = flags;
+            record->alarm = alarm;
+            record->channel = channel;
+            // The alarm covers the one record that follows it
+            flags &= ~SENSORS_RECORD_ALARM;
+            alarm = 0;
+            channel = 0;
+            position += 2 + length;
+        } else {
+            _malformed++;
+            break;
+        }
+    }
+    _records += count;
+    return count;
+}
+
+uint64_t SensorsDecoder::getPayloads()
+{
+    return _payloads;
+}
+
+uint64_t SensorsDecoder::getRecords()
+{
+    return _records;
+}
+
+uint64_t SensorsDecoder::getMalformed()
+{
+    return _malformed;
+}
+
+uint64_t SensorsDecoder::getTruncated()
+{
+    return _truncated;
+}
+
+size_t sensorsPutTime(uint8_t *data, uint32_t time)
+{
+    data[0] = XBEE_TIME_HEADER;
+    for (uint8_t i = 0; i < SENSORS_NODE_TIME_SIZE; i++) {
+        data[1 + i] = time >> ((SENSORS_NODE_TIME_SIZE - 1 - i) * 8);
+    }
+    return 1 + SENSORS_NODE_TIME_SIZE;
+}
+
+// Returns 0 for a sensor without a known value size
+size_t sensorsPutValue(uint8_t *data, uint8_t sensor, int32_t value)
+{
+    uint8_t length = sensorsValueSize(sensor);
+    if (length == 0) {
+        return 0;
+    }
+    data[0] = XBEE_SENSOR_HEADER;
+    data[1] = sensor;
+    for (uint8_t i = 0; i < length; i++) {
+        data[2 + i] = (uint32_t)value >> ((length - 1 - i) * 8);
+    }
+    return 2 + length;
+}
@@ -0,0 +1,90 @@
+//
+//  SensorsRecord
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  The records of putXBeeData() as the gateway sees them. A payload is
+//  walked record by record: every record starts with a header byte and
+//  has a fixed size, sensor records carry the type and sensor id in the
+//  second byte. Values are big endian with the AVR sizes (int 2, long 4,
+//  time_t 4 bytes). Sensor records take the time of the last time record
+//  in front of them, or the arrival time when the payload has none.
+//
+
+#ifndef SensorsRecord_h
+#define SensorsRecord_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Same as src/Sensors.h
+#define XBEE_STALE_HEADER           0x04
+#define XBEE_ALARM_HEADER           0x08
+#define XBEE_TIME_HEADER            0x10
+#define XBEE_REQUEST_HEADER         0x20
+#define XBEE_SENSOR_HEADER          0x40
+#define XBEE_POWER_HEADER           0x80
+
+#define XBEE_TEMPERATURE_HEADER     0x01 << 3   // T
+#define XBEE_HUMIDITY_HEADER        0x03 << 3   // H
+#define XBEE_DEWPOINT_HEADER        0x04 << 3   // D
+#define XBEE_LUX_HEADER             0x08 << 3   // L
+#define XBEE_IR_HEADER              0x09 << 3   // I
+#define XBEE_VISIBLE_HEADER         0x0A << 3   // V
+#define XBEE_FULL_HEADER            0x0B << 3   // F
+#define XBEE_PRESSURE_HEADER        0x0C << 3   // P
+#define XBEE_ALTITUDE_HEADER        0x0D << 3   // A
+
+#define SENSORS_FLOAT_TO_INT_MULTIPLY       100
+
+// Sizes on the node
+#define SENSORS_NODE_INT_SIZE               2
+#define SENSORS_NODE_LONG_SIZE              4
+#define SENSORS_NODE_TIME_SIZE              4
+
+#define SENSORS_RECORD_TYPE(sensor)         ((sensor) >> 3)
+#define SENSORS_RECORD_ID(sensor)           ((sensor) & 0x07)
+
+// SensorsRecord flags
+#define SENSORS_RECORD_STALE                0x01    // Restored after a restart of the node
+#define SENSORS_RECORD_ALARM                0x02    // Sent with an alarm event, see alarm
+#define SENSORS_RECORD_ARRIVAL              0x04    // No time record, time is the arrival
+
+struct SensorsRecord
+{
+    uint64_t    node;           // 64-bit source address, 0 when unknown
+    int64_t     time;           // s
+    int32_t     value;          // Centi-units, Pa or m
+    uint8_t     sensor;         // XBEE_*_HEADER | sensor id
+    uint8_t     flags;          // SENSORS_RECORD_*
+    uint8_t     alarm;          // Event bits of the alarm record
+    uint8_t     channel;        // Channel of the alarm record
+};
+
+class SensorsDecoder
+{
+public:
+    size_t decode(uint64_t node, const uint8_t *data, size_t size, int64_t arrival, SensorsRecord *records, size_t capacity);
+
+    uint64_t getPayloads();
+    uint64_t getRecords();
+    uint64_t getMalformed();
+    uint64_t getTruncated();
+
+private:
+    uint64_t    _payloads       =   0;
+    uint64_t    _records        =   0;
+    uint64_t    _malformed      =   0;
+    uint64_t    _truncated      =   0;
+};
+
+uint8_t sensorsValueSize(uint8_t sensor);
+
+// Writers in the node format, for replays, tests and benchmarks
+size_t sensorsPutTime(uint8_t *data, uint32_t time);
+size_t sensorsPutValue(uint8_t *data, uint8_t sensor, int32_t value);
+
+#endif
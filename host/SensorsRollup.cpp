@@ -0,0 +1,248 @@
+//
+//  SensorsRollup
+//  Host C++ code
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <algorithm>
+
+#include <SensorsRollup.h>
+
+static inline int64_t floorDivide(int64_t value, int64_t divisor)
+{
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+static inline int64_t ceilDivide(int64_t value, int64_t divisor)
+{
+    return -floorDivide(-value, divisor);
+}
+
+static inline uint32_t getSlot(int64_t number, uint32_t buckets)
+{
+    int64_t slot = number % buckets;
+    return slot < 0 ? slot + buckets : slot;
+}
+
+double SensorsRollupBucket::getMean() const
+{
+    return count > 0 ? (double)sum / count : 0.0;
+}
+
+void SensorsRollupBucket::merge(const SensorsRollupBucket &bucket)
+{
+    if (bucket.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        min = bucket.min;
+        max = bucket.max;
+    } else {
+        min = std::min(min, bucket.min);
+        max = std::max(max, bucket.max);
+    }
+    sum += bucket.sum;
+    count += bucket.count;
+}
+
+SensorsRollup::SensorsRollup()
+{
+    static const SensorsRollupLevel levels[3] = {
+        { SENSORS_ROLLUP_MINUTE, SENSORS_ROLLUP_MINUTES },
+        { SENSORS_ROLLUP_HOUR, SENSORS_ROLLUP_HOURS },
+        { SENSORS_ROLLUP_DAY, SENSORS_ROLLUP_DAYS }
+    };
+    setLevels(levels, 3);
+}
+
+SensorsRollup::SensorsRollup(const SensorsRollupLevel *levels, uint8_t count)
+{
+    setLevels(levels, count);
+}
+
+// Stale records are readings a node restored after a restart, they were
+// counted when first sent
+void SensorsRollup::update(const SensorsRecord &record)
+{
+    if (record.flags & SENSORS_RECORD_STALE) {
+        _stale++;
+        return;
+    }
+    size_t series = findSeries(record.node, record.sensor, true);
+    SensorsRollupBucket *buckets = &_buckets[series * _seriesBuckets];
+    int64_t *newest = &_newest[series * _levelCount];
+    for (uint8_t level = 0; level < _levelCount; level++) {
+        const SensorsRollupLevel *rollup = &_levels[level];
+        int64_t number = floorDivide(record.time, rollup->seconds);
+        if (number <= newest[level] - rollup->buckets) {
+            _late++;
+            continue;
+        }
+        newest[level] = std::max(newest[level], number);
+        SensorsRollupBucket *bucket = &buckets[_offsets[level] + getSlot(number, rollup->buckets)];
+        int64_t start = number * rollup->seconds;
+        if (bucket->start != start) {
+            bucket->start = start;
+            bucket->sum = 0;
+            bucket->min = record.value;
+            bucket->max = record.value;
+            bucket->count = 0;
+        }
+        bucket->sum += record.value;
+        bucket->min = std::min(bucket->min, record.value);
+        bucket->max = std::max(bucket->max, record.value);
+        bucket->count++;
+    }
+}
+
+void SensorsRollup::update(const SensorsRecord *records, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        update(records[i]);
+    }
+}
+
+// The buckets of one level that start in [from, to) and hold records,
+// oldest first. Returns the number appended.
+size_t SensorsRollup::query(uint64_t node, uint8_t sensor, uint8_t level, int64_t from, int64_t to, std::vector<SensorsRollupBucket> *buckets)
+{
+    size_t series = findSeries(node, sensor, false);
+    if (series == SENSORS_ROLLUP_NO_SERIES || level >= _levelCount || from >= to) {
+        return 0;
+    }
+    const SensorsRollupLevel *rollup = &_levels[level];
+    int64_t newest = _newest[series * _levelCount + level];
+    int64_t first = std::max(ceilDivide(from, rollup->seconds), newest - rollup->buckets + 1);
+    int64_t end = std::min(ceilDivide(to, rollup->seconds), newest + 1);
+    const SensorsRollupBucket *ring = &_buckets[series * _seriesBuckets + _offsets[level]];
+    size_t found = 0;
+    for (int64_t number = first; number < end; number++) {
+        const SensorsRollupBucket *bucket = &ring[getSlot(number, rollup->buckets)];
+        if (bucket->start == number * rollup->seconds && bucket->count > 0) {
+            buckets->push_back(*bucket);
+            found++;
+        }
+    }
+    return found;
+}
+
+// Min, max and mean over [from, to), rounded out to the finest level.
+// Whole days come from the day ring, the edges from hours and minutes.
+// Returns false when part of the range is older than the rings hold.
+bool SensorsRollup::summarize(uint64_t node, uint8_t sensor, int64_t from, int64_t to, SensorsRollupBucket *result)
+{
+    result->start = from;
+    result->sum = 0;
+    result->min = 0;
+    result->max = 0;
+    result->count = 0;
+    size_t series = findSeries(node, sensor, false);
+    if (series == SENSORS_ROLLUP_NO_SERIES || from >= to) {
+        return true;
+    }
+    int64_t seconds = _levels[0].seconds;
+    return combine(series, _levelCount - 1, floorDivide(from, seconds) * seconds, ceilDivide(to, seconds) * seconds, result);
+}
+
+uint8_t SensorsRollup::getLevels()
+{
+    return _levelCount;
+}
+
+size_t SensorsRollup::getSeries()
+{
+    return _series;
+}
+
+// Level updates that were too old for their ring
+uint64_t SensorsRollup::getLate()
+{
+    return _late;
+}
+
+uint64_t SensorsRollup::getStale()
+{
+    return _stale;
+}
+
+void SensorsRollup::setLevels(const SensorsRollupLevel *levels, uint8_t count)
+{
+    _levelCount = std::min(count, (uint8_t)SENSORS_ROLLUP_LEVELS);
+    _seriesBuckets = 0;
+    for (uint8_t level = 0; level < _levelCount; level++) {
+        _levels[level] = levels[level];
+        _offsets[level] = _seriesBuckets;
+        _seriesBuckets += levels[level].buckets;
+    }
+}
+
+size_t SensorsRollup::findSeries(uint64_t node, uint8_t sensor, bool create)
+{
+    if (_lastTable == SENSORS_ROLLUP_NO_TABLE || node != _lastNode) {
+        std::unordered_map<uint64_t, uint32_t>::iterator found = _nodes.find(node);
+        if (found != _nodes.end()) {
+            _lastTable = found->second;
+        } else if (create) {
+            _lastTable = _sensors.size() / SENSORS_ROLLUP_SENSORS;
+            _sensors.resize(_sensors.size() + SENSORS_ROLLUP_SENSORS, 0);
+            _nodes[node] = _lastTable;
+        } else {
+            return SENSORS_ROLLUP_NO_SERIES;
+        }
+        _lastNode = node;
+    }
+    uint32_t *slot = &_sensors[_lastTable * SENSORS_ROLLUP_SENSORS + sensor];
+    if (*slot == 0) {
+        if (!create) {
+            return SENSORS_ROLLUP_NO_SERIES;
+        }
+        SensorsRollupBucket empty = { SENSORS_ROLLUP_EMPTY, 0, 0, 0, 0 };
+        _buckets.resize(_buckets.size() + _seriesBuckets, empty);
+        _newest.resize(_newest.size() + _levelCount, SENSORS_ROLLUP_NEVER);
+        *slot = ++_series;
+    }
+    return *slot - 1;
+}
+
+// Buckets first <= number < end of one level into result, false when the
+// ring no longer holds some of them
+bool SensorsRollup::collect(size_t series, uint8_t level, int64_t first, int64_t end, SensorsRollupBucket *result)
+{
+    const SensorsRollupLevel *rollup = &_levels[level];
+    int64_t newest = _newest[series * _levelCount + level];
+    int64_t oldest = newest - rollup->buckets + 1;
+    const SensorsRollupBucket *ring = &_buckets[series * _seriesBuckets + _offsets[level]];
+    for (int64_t number = std::max(first, oldest); number < std::min(end, newest + 1); number++) {
+        const SensorsRollupBucket *bucket = &ring[getSlot(number, rollup->buckets)];
+        if (bucket->start == number * rollup->seconds) {
+            result->merge(*bucket);
+        }
+    }
+    return first >= oldest;
+}
+
+// The part of [from, to) aligned to this level from its ring, the edges
+// from the finer levels. from and to are aligned to level 0. The coarser
+// rings reach further back, so a finer one cannot fill in for them.
+bool SensorsRollup::combine(size_t series, uint8_t level, int64_t from, int64_t to, SensorsRollupBucket *result)
+{
+    if (from >= to) {
+        return true;
+    }
+    int64_t seconds = _levels[level].seconds;
+    int64_t first = ceilDivide(from, seconds);
+    int64_t end = floorDivide(to, seconds);
+    if (level == 0) {
+        return collect(series, level, first, end, result);
+    }
+    if (first >= end) {
+        return combine(series, level - 1, from, to, result);
+    }
+    bool complete = combine(series, level - 1, from, first * seconds, result);
+    complete = collect(series, level, first, end, result) && complete;
+    return combine(series, level - 1, end * seconds, to, result) && complete;
+}
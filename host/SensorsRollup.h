@@ -0,0 +1,102 @@
+//
+//  SensorsRollup
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Min, max and mean of every (node, sensor) series per minute, hour
+//  and day, updated as records arrive. Each resolution is a ring of
+//  buckets indexed by time / seconds, so an update is O(1) and a series
+//  takes the same memory however long it runs. Late and out-of-order
+//  records land in their own bucket as long as the ring still holds it;
+//  older ones are dropped at that resolution only, a coarser ring may
+//  still take them.
+//
+
+#ifndef SensorsRollup_h
+#define SensorsRollup_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include <SensorsRecord.h>
+
+#define SENSORS_ROLLUP_LEVELS           4
+#define SENSORS_ROLLUP_SENSORS          256
+#define SENSORS_ROLLUP_NO_TABLE         ((size_t)-1)
+#define SENSORS_ROLLUP_NO_SERIES        ((size_t)-1)
+#define SENSORS_ROLLUP_EMPTY            INT64_MIN
+#define SENSORS_ROLLUP_NEVER            (INT64_MIN / 2)     // Newest bucket of a new series
+
+// Default rings: 2 h of minutes, 2 days of hours, 2 months of days
+#define SENSORS_ROLLUP_MINUTE           60
+#define SENSORS_ROLLUP_MINUTES          120
+#define SENSORS_ROLLUP_HOUR             3600
+#define SENSORS_ROLLUP_HOURS            48
+#define SENSORS_ROLLUP_DAY              86400
+#define SENSORS_ROLLUP_DAYS             62
+
+struct SensorsRollupLevel
+{
+    int64_t     seconds;        // Each a multiple of the one before
+    uint32_t    buckets;
+};
+
+struct SensorsRollupBucket
+{
+    int64_t     start;          // s, SENSORS_ROLLUP_EMPTY when unused
+    int64_t     sum;
+    int32_t     min;
+    int32_t     max;
+    uint32_t    count;
+
+    double getMean() const;
+    void merge(const SensorsRollupBucket &bucket);
+};
+
+class SensorsRollup
+{
+public:
+    SensorsRollup();
+    SensorsRollup(const SensorsRollupLevel *levels, uint8_t count);
+
+    void update(const SensorsRecord &record);
+    void update(const SensorsRecord *records, size_t count);
+
+    size_t query(uint64_t node, uint8_t sensor, uint8_t level, int64_t from, int64_t to, std::vector<SensorsRollupBucket> *buckets);
+    bool summarize(uint64_t node, uint8_t sensor, int64_t from, int64_t to, SensorsRollupBucket *result);
+
+    uint8_t getLevels();
+    size_t getSeries();
+    uint64_t getLate();
+    uint64_t getStale();
+
+private:
+    SensorsRollupLevel                          _levels[SENSORS_ROLLUP_LEVELS];
+    uint8_t                                     _levelCount     =   0;
+    uint32_t                                    _offsets[SENSORS_ROLLUP_LEVELS];
+    uint32_t                                    _seriesBuckets  =   0;
+    // Rings of all levels back to back, one run per series
+    std::vector<SensorsRollupBucket>            _buckets;
+    // Newest bucket number per series and level
+    std::vector<int64_t>                        _newest;
+    // Series index + 1 per sensor byte, one table per node
+    std::unordered_map<uint64_t, uint32_t>      _nodes;
+    std::vector<uint32_t>                       _sensors;
+    size_t                                      _series         =   0;
+    uint64_t                                    _lastNode       =   0;
+    size_t                                      _lastTable      =   SENSORS_ROLLUP_NO_TABLE;
+    uint64_t                                    _late           =   0;
+    uint64_t                                    _stale          =   0;
+
+    void setLevels(const SensorsRollupLevel *levels, uint8_t count);
+    size_t findSeries(uint64_t node, uint8_t sensor, bool create);
+    bool collect(size_t series, uint8_t level, int64_t first, int64_t end, SensorsRollupBucket *result);
+    bool combine(size_t series, uint8_t level, int64_t from, int64_t to, SensorsRollupBucket *result);
+};
+
+#endif
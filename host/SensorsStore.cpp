@@ -0,0 +1,488 @@
+//
+//  SensorsStore
+//  Host C++ code
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <SensorsStore.h>
+
+#define SENSORS_STORE_HEADER_SIZE       16
+#define SENSORS_STORE_ALIGN(size)       (((size) + 7) & ~(size_t)7)
+
+static inline uint64_t zigzag(uint64_t value)
+{
+    return (value << 1) ^ (uint64_t)((int64_t)value >> 63);
+}
+
+static inline uint64_t unzigzag(uint64_t value)
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+// Up to 32 bits, the accumulator never holds more than 39
+static inline void putBits(SensorsColumn *column, uint64_t value, uint8_t size)
+{
+    column->bits = (column->bits << size) | (value & ((1ULL << size) - 1));
+    column->pending += size;
+    while (column->pending >= 8) {
+        column->pending -= 8;
+        column->data[column->bytes++] = column->bits >> column->pending;
+    }
+}
+
+static inline void putWide(SensorsColumn *column, uint64_t value, uint8_t size)
+{
+    if (size > 32) {
+        putBits(column, value >> 32, size - 32);
+        size = 32;
+    }
+    putBits(column, value, size);
+}
+
+struct SensorsBitReader
+{
+    const uint8_t   *data;
+    size_t          size;
+    size_t          position;
+    uint64_t        bits;
+    uint8_t         available;
+
+    inline uint64_t get(uint8_t count)
+    {
+        while (available < count) {
+            bits = (bits << 8) | (position < size ? data[position++] : 0);
+            available += 8;
+        }
+        available -= count;
+        return (bits >> available) & ((1ULL << count) - 1);
+    }
+
+    inline uint64_t getWide(uint8_t count)
+    {
+        uint64_t value = 0;
+        if (count > 32) {
+            value = get(count - 32) << 32;
+            count = 32;
+        }
+        return value | get(count);
+    }
+
+    // Ones before the first zero, at most limit
+    inline uint8_t getPrefix(uint8_t limit)
+    {
+        uint8_t ones = 0;
+        while (ones < limit && get(1)) {
+            ones++;
+        }
+        return ones;
+    }
+};
+
+// Appends the points of [from, to) in the order they were stored
+static size_t decodeBlock(const uint8_t *data, size_t bytes, uint16_t count, int64_t from, int64_t to, std::vector<int64_t> *times, std::vector<int32_t> *values)
+{
+    static const uint8_t timeSizes[5] = { 0, 7, 12, 20, 64 };
+    static const uint8_t valueSizes[4] = { 0, 6, 13, 33 };
+    SensorsBitReader reader = { data, bytes, 0, 0, 0 };
+    size_t found = 0;
+    uint64_t time = 0;
+    uint64_t delta = 0;
+    uint64_t value = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (i == 0) {
+            time = reader.getWide(64);
+            value = (uint64_t)(int64_t)(int32_t)reader.get(32);
+        } else {
+            uint8_t size = timeSizes[reader.getPrefix(4)];
+            delta += size ? unzigzag(reader.getWide(size)) : 0;
+            time += delta;
+            size = valueSizes[reader.getPrefix(3)];
+            value += size ? unzigzag(reader.getWide(size)) : 0;
+        }
+        if ((int64_t)time >= from && (int64_t)time < to) {
+            times->push_back((int64_t)time);
+            values->push_back((int32_t)value);
+            found++;
+        }
+    }
+    return found;
+}
+
+SensorsStore::~SensorsStore()
+{
+    close();
+}
+
+// Loads the segments in the directory, creating it when needed
+bool SensorsStore::open(const char *directory, size_t segmentSize)
+{
+    close();
+    _directory = directory;
+    _segmentSize = segmentSize;
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    DIR *dir = opendir(directory);
+    if (dir == NULL) {
+        return false;
+    }
+    std::vector<std::string> names;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        unsigned int number;
+        if (sscanf(entry->d_name, "segment-%u.sss", &number) == 1) {
+            names.push_back(entry->d_name);
+            _nextSegment = std::max(_nextSegment, (uint32_t)number + 1);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    _open = true;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!load(_directory + "/" + names[i])) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Seals the open blocks and truncates the last segments to what is used
+void SensorsStore::close()
+{
+    if (_open) {
+        flush();
+    }
+    for (size_t i = 0; i < _segments.size(); i++) {
+        SensorsSegment *segment = &_segments[i];
+        munmap(segment->data, segment->capacity);
+        if (segment->writable) {
+            if (ftruncate(segment->fd, segment->used) != 0) {
+                perror("SensorsStore");
+            }
+        }
+        ::close(segment->fd);
+    }
+    _segments.clear();
+    for (size_t i = 0; i < _columns.size(); i++) {
+        delete _columns[i];
+    }
+    _columns.clear();
+    _nodes.clear();
+    _sensors.clear();
+    _lastTable = SENSORS_STORE_NO_TABLE;
+    _nextSegment = 0;
+    _points = 0;
+    _blocks = 0;
+    _bytes = 0;
+    _open = false;
+}
+
+bool SensorsStore::append(const SensorsRecord &record)
+{
+    SensorsColumn *column = getColumn(record.node, record.sensor, true);
+    if (column->count == SENSORS_STORE_BLOCK_POINTS || column->bytes + 1 + SENSORS_STORE_POINT_BYTES > SENSORS_STORE_BLOCK_BYTES) {
+        if (!seal(column)) {
+            return false;
+        }
+    }
+    if (column->count == 0) {
+        putWide(column, record.time, 64);
+        putBits(column, (uint32_t)record.value, 32);
+        column->lastDelta = 0;
+        column->minTime = record.time;
+        column->maxTime = record.time;
+    } else {
+        uint64_t delta = (uint64_t)record.time - (uint64_t)column->lastTime;
+        uint64_t time = zigzag(delta - (uint64_t)column->lastDelta);
+        if (time == 0) {
+            putBits(column, 0x0, 1);
+        } else if (time < (1ULL << 7)) {
+            putBits(column, (0x2ULL << 7) | time, 2 + 7);
+        } else if (time < (1ULL << 12)) {
+            putBits(column, (0x6ULL << 12) | time, 3 + 12);
+        } else if (time < (1ULL << 20)) {
+            putBits(column, (0xEULL << 20) | time, 4 + 20);
+        } else {
+            putBits(column, 0xF, 4);
+            putWide(column, time, 64);
+        }
+        uint64_t value = zigzag((uint64_t)((int64_t)record.value - column->lastValue));
+        if (value == 0) {
+            putBits(column, 0x0, 1);
+        } else if (value < (1ULL << 6)) {
+            putBits(column, (0x2ULL << 6) | value, 2 + 6);
+        } else if (value < (1ULL << 13)) {
+            putBits(column, (0x6ULL << 13) | value, 3 + 13);
+        } else {
+            putBits(column, 0x7, 3);
+            putWide(column, value, 33);
+        }
+        column->lastDelta = delta;
+        column->minTime = std::min(column->minTime, record.time);
+        column->maxTime = std::max(column->maxTime, record.time);
+    }
+    column->lastTime = record.time;
+    column->lastValue = record.value;
+    column->count++;
+    _points++;
+    return true;
+}
+
+size_t SensorsStore::append(const SensorsRecord *records, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!append(records[i])) {
+            return i;
+        }
+    }
+    return count;
+}
+
+// Seals every open block and syncs the segments, small blocks are the
+// price of flushing often
+bool SensorsStore::flush()
+{
+    bool result = true;
+    for (size_t i = 0; i < _columns.size(); i++) {
+        if (_columns[i]->count > 0 && !seal(_columns[i])) {
+            result = false;
+        }
+    }
+    for (size_t i = 0; i < _segments.size(); i++) {
+        SensorsSegment *segment = &_segments[i];
+        if (segment->writable && msync(segment->data, segment->used, MS_SYNC) != 0) {
+            result = false;
+        }
+    }
+    return result;
+}
+
+// Points of one column with from <= time < to, sealed blocks first and
+// then the open block. Returns the number of points appended.
+size_t SensorsStore::scan(uint64_t node, uint8_t sensor, int64_t from, int64_t to, std::vector<int64_t> *times, std::vector<int32_t> *values)
+{
+    SensorsColumn *column = getColumn(node, sensor, false);
+    if (column == NULL || from >= to) {
+        return 0;
+    }
+    size_t found = 0;
+    size_t first = 0;
+    if (column->ordered) {
+        first = std::lower_bound(column->blocks.begin(), column->blocks.end(), from, [](const SensorsBlock &block, int64_t time) {
+            return block.maxTime < time;
+        }) - column->blocks.begin();
+    }
+    for (size_t i = first; i < column->blocks.size(); i++) {
+        const SensorsBlock *block = &column->blocks[i];
+        if (block->minTime >= to) {
+            if (column->ordered) {
+                break;
+            }
+            continue;
+        }
+        if (block->maxTime < from) {
+            continue;
+        }
+        const SensorsBlockHeader *header = block->header;
+        found += decodeBlock((const uint8_t *)(header + 1), header->bytes, header->count, from, to, times, values);
+    }
+    if (column->count > 0 && column->minTime < to && column->maxTime >= from) {
+        uint8_t data[SENSORS_STORE_BLOCK_BYTES + 1];
+        memcpy(data, column->data, column->bytes);
+        size_t bytes = column->bytes;
+        if (column->pending > 0) {
+            data[bytes++] = column->bits << (8 - column->pending);
+        }
+        found += decodeBlock(data, bytes, column->count, from, to, times, values);
+    }
+    return found;
+}
+
+size_t SensorsStore::getColumns()
+{
+    return _columns.size();
+}
+
+size_t SensorsStore::getSegments()
+{
+    return _segments.size();
+}
+
+uint64_t SensorsStore::getPoints()
+{
+    return _points;
+}
+
+uint64_t SensorsStore::getBlocks()
+{
+    return _blocks;
+}
+
+// Bytes of sealed blocks including their headers
+uint64_t SensorsStore::getBytes()
+{
+    return _bytes;
+}
+
+SensorsColumn *SensorsStore::getColumn(uint64_t node, uint8_t sensor, bool create)
+{
+    if (_lastTable == SENSORS_STORE_NO_TABLE || node != _lastNode) {
+        std::unordered_map<uint64_t, uint32_t>::iterator found = _nodes.find(node);
+        if (found != _nodes.end()) {
+            _lastTable = found->second;
+        } else if (create) {
+            _lastTable = _sensors.size() / SENSORS_STORE_SENSORS;
+            _sensors.resize(_sensors.size() + SENSORS_STORE_SENSORS, 0);
+            _nodes[node] = _lastTable;
+        } else {
+            return NULL;
+        }
+        _lastNode = node;
+    }
+    uint32_t *slot = &_sensors[_lastTable * SENSORS_STORE_SENSORS + sensor];
+    if (*slot == 0) {
+        if (!create) {
+            return NULL;
+        }
+        SensorsColumn *column = new SensorsColumn();
+        column->node = node;
+        column->sensor = sensor;
+        column->ordered = true;
+        _columns.push_back(column);
+        *slot = _columns.size();
+    }
+    return _columns[*slot - 1];
+}
+
+// Maps a segment read only and indexes its blocks up to the first one
+// without a magic, the tail of a segment that was cut off by a crash
+bool SensorsStore::load(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < SENSORS_STORE_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    uint8_t *data = (uint8_t *)mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    if (magic != SENSORS_STORE_SEGMENT_MAGIC) {
+        munmap(data, info.st_size);
+        ::close(fd);
+        return false;
+    }
+    SensorsSegment segment = { fd, data, SENSORS_STORE_HEADER_SIZE, (size_t)info.st_size, false };
+    while (segment.used + sizeof(SensorsBlockHeader) <= segment.capacity) {
+        const SensorsBlockHeader *header = (const SensorsBlockHeader *)(data + segment.used);
+        size_t size = SENSORS_STORE_ALIGN(sizeof(SensorsBlockHeader) + header->bytes);
+        if (header->magic != SENSORS_STORE_BLOCK_MAGIC || segment.used + size > segment.capacity) {
+            break;
+        }
+        index(getColumn(header->node, header->sensor, true), header);
+        _points += header->count;
+        segment.used += size;
+    }
+    _segments.push_back(segment);
+    return true;
+}
+
+// Copies the open block of the column into a segment, the magic goes in
+// last so a reader never sees half a block
+bool SensorsStore::seal(SensorsColumn *column)
+{
+    if (column->pending > 0) {
+        column->data[column->bytes++] = column->bits << (8 - column->pending);
+        column->pending = 0;
+    }
+    size_t size = SENSORS_STORE_ALIGN(sizeof(SensorsBlockHeader) + column->bytes);
+    SensorsSegment *segment = reserve(size);
+    if (segment == NULL) {
+        return false;
+    }
+    SensorsBlockHeader *header = (SensorsBlockHeader *)(segment->data + segment->used);
+    memcpy(header + 1, column->data, column->bytes);
+    header->count = column->count;
+    header->bytes = column->bytes;
+    header->node = column->node;
+    header->minTime = column->minTime;
+    header->maxTime = column->maxTime;
+    header->sensor = column->sensor;
+    memset(header->reserved, 0, sizeof(header->reserved));
+    __atomic_store_n(&header->magic, SENSORS_STORE_BLOCK_MAGIC, __ATOMIC_RELEASE);
+    segment->used += size;
+    index(column, header);
+    column->bytes = 0;
+    column->bits = 0;
+    column->count = 0;
+    return true;
+}
+
+// The last segment when the block fits, else a new one. The tail of a
+// full segment stays unused and is cut off by close().
+SensorsSegment *SensorsStore::reserve(size_t size)
+{
+    if (!_segments.empty()) {
+        SensorsSegment *segment = &_segments.back();
+        if (segment->writable && segment->used + size <= segment->capacity) {
+            return segment;
+        }
+    }
+    if (SENSORS_STORE_HEADER_SIZE + size > _segmentSize) {
+        return NULL;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "/segment-%06u.sss", _nextSegment);
+    std::string path = _directory + name;
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, _segmentSize) != 0) {
+        ::close(fd);
+        return NULL;
+    }
+    uint8_t *data = (uint8_t *)mmap(NULL, _segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return NULL;
+    }
+    uint32_t header[4] = { SENSORS_STORE_SEGMENT_MAGIC, SENSORS_STORE_VERSION, 0, 0 };
+    memcpy(data, header, sizeof(header));
+    SensorsSegment segment = { fd, data, SENSORS_STORE_HEADER_SIZE, _segmentSize, true };
+    _segments.push_back(segment);
+    _nextSegment++;
+    return &_segments.back();
+}
+
+void SensorsStore::index(SensorsColumn *column, const SensorsBlockHeader *header)
+{
+    if (!column->blocks.empty() && header->minTime < column->blocks.back().maxTime) {
+        column->ordered = false;
+    }
+    SensorsBlock block = { header, header->minTime, header->maxTime };
+    column->blocks.push_back(block);
+    _blocks++;
+    _bytes += SENSORS_STORE_ALIGN(sizeof(SensorsBlockHeader) + header->bytes);
+}
@@ -0,0 +1,129 @@
+//
+//  SensorsStore
+//  Host header
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Columnar store for decoded records. Every (node, sensor) pair is a
+//  column of blocks of up to SENSORS_STORE_BLOCK_POINTS points. In a
+//  block timestamps are delta-of-delta and values delta encoded, both
+//  zigzag with a short prefix for the bit width. Full blocks are
+//  appended to memory mapped segment files that are never rewritten:
+//  segments found by open() are read only, new blocks go to new ones.
+//
+
+#ifndef SensorsStore_h
+#define SensorsStore_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SensorsRecord.h>
+
+#define SENSORS_STORE_SEGMENT_SIZE      (64UL << 20)
+#define SENSORS_STORE_BLOCK_POINTS      1024
+#define SENSORS_STORE_BLOCK_BYTES       1024
+// Worst case of one point: 4 + 64 bits time, 3 + 64 bits value
+#define SENSORS_STORE_POINT_BYTES       17
+#define SENSORS_STORE_SEGMENT_MAGIC     0x53535347  // SSSG
+#define SENSORS_STORE_BLOCK_MAGIC       0x53534B42  // SSKB
+#define SENSORS_STORE_VERSION           1
+#define SENSORS_STORE_SENSORS           256
+#define SENSORS_STORE_NO_TABLE          ((size_t)-1)
+
+struct SensorsBlockHeader
+{
+    uint32_t    magic;          // Written last, a torn block has none
+    uint16_t    count;
+    uint16_t    bytes;          // Encoded points after the header
+    uint64_t    node;
+    int64_t     minTime;
+    int64_t     maxTime;
+    uint8_t     sensor;
+    uint8_t     reserved[7];
+};
+
+struct SensorsBlock
+{
+    const SensorsBlockHeader    *header;
+    int64_t                     minTime;
+    int64_t                     maxTime;
+};
+
+struct SensorsSegment
+{
+    int         fd;
+    uint8_t     *data;
+    size_t      used;
+    size_t      capacity;
+    bool        writable;
+};
+
+struct SensorsColumn
+{
+    uint64_t                    node;
+    uint8_t                     sensor;
+    std::vector<SensorsBlock>   blocks;
+    bool                        ordered;        // Blocks do not overlap and ascend
+    // Open block
+    uint8_t                     data[SENSORS_STORE_BLOCK_BYTES];
+    size_t                      bytes;
+    uint64_t                    bits;
+    uint8_t                     pending;        // Bits in bits not yet in data
+    uint16_t                    count;
+    int64_t                     lastTime;
+    int64_t                     lastDelta;
+    int32_t                     lastValue;
+    int64_t                     minTime;
+    int64_t                     maxTime;
+};
+
+class SensorsStore
+{
+public:
+    ~SensorsStore();
+
+    bool open(const char *directory, size_t segmentSize = SENSORS_STORE_SEGMENT_SIZE);
+    void close();
+
+    bool append(const SensorsRecord &record);
+    size_t append(const SensorsRecord *records, size_t count);
+    bool flush();
+
+    size_t scan(uint64_t node, uint8_t sensor, int64_t from, int64_t to, std::vector<int64_t> *times, std::vector<int32_t> *values);
+
+    size_t getColumns();
+    size_t getSegments();
+    uint64_t getPoints();
+    uint64_t getBlocks();
+    uint64_t getBytes();
+
+private:
+    std::string                                 _directory;
+    size_t                                      _segmentSize    =   SENSORS_STORE_SEGMENT_SIZE;
+    std::vector<SensorsSegment>                 _segments;
+    std::vector<SensorsColumn *>                _columns;
+    // Column index + 1 per sensor byte, one table per node
+    std::unordered_map<uint64_t, uint32_t>      _nodes;
+    std::vector<uint32_t>                       _sensors;
+    uint64_t                                    _lastNode       =   0;
+    size_t                                      _lastTable      =   SENSORS_STORE_NO_TABLE;
+    uint32_t                                    _nextSegment    =   0;
+    uint64_t                                    _points         =   0;
+    uint64_t                                    _blocks         =   0;
+    uint64_t                                    _bytes          =   0;
+    bool                                        _open           =   false;
+
+    SensorsColumn *getColumn(uint64_t node, uint8_t sensor, bool create);
+    bool load(const std::string &path);
+    bool seal(SensorsColumn *column);
+    SensorsSegment *reserve(size_t size);
+    void index(SensorsColumn *column, const SensorsBlockHeader *header);
+};
+
+#endif
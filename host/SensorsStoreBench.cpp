@@ -0,0 +1,162 @@
+//
+//  SensorsStoreBench
+//  Host benchmark
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Decodes a stream of payloads as putXBeeData() writes them, one every
+//  minute per node with time, temperatures, humidity, light and
+//  pressure, and ingests it into a SensorsStore. Reports decode and
+//  ingest rates, bytes per point, range scans and reopening.
+//
+//  Usage: SensorsStoreBench [payloads] [nodes] [directory]
+//
+
+#include <chrono>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <SensorsStore.h>
+
+#define BENCH_SENSORS   8
+
+static const uint8_t sensors[BENCH_SENSORS] = {
+    XBEE_TEMPERATURE_HEADER | 0x01, XBEE_TEMPERATURE_HEADER | 0x02, XBEE_HUMIDITY_HEADER | 0x01, XBEE_TEMPERATURE_HEADER | 0x03,
+    XBEE_LUX_HEADER | 0x02, XBEE_IR_HEADER | 0x02, XBEE_FULL_HEADER | 0x02, XBEE_PRESSURE_HEADER | 0x01
+};
+
+struct BenchPayload
+{
+    uint64_t    node;
+    size_t      offset;
+    uint8_t     size;
+};
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void removeDirectory(const std::string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            unlink((directory + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    size_t payloads = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+    size_t nodes = argc > 2 ? strtoul(argv[2], NULL, 0) : 1000;
+    char temporary[] = "/tmp/SensorsStoreBench-XXXXXX";
+    std::string directory = argc > 3 ? argv[3] : mkdtemp(temporary);
+
+    // Slow random walks, as a room would change minute by minute
+    srand(26);
+    std::vector<uint8_t> stream;
+    std::vector<BenchPayload> index;
+    std::vector<int32_t> levels(nodes * BENCH_SENSORS);
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i] = sensors[i % BENCH_SENSORS] == (XBEE_PRESSURE_HEADER | 0x01) ? 101325 : 2000;
+    }
+    stream.reserve(payloads * 48);
+    uint32_t start = 1571443200;
+    for (size_t i = 0; i < payloads; i++) {
+        uint64_t node = 0x0013A20040000000ULL + i % nodes;
+        uint32_t time = start + (i / nodes) * 60 + (rand() % 16 == 0 ? 1 : 0);
+        uint8_t payload[64];
+        size_t size = sensorsPutTime(payload, time);
+        for (uint8_t s = 0; s < BENCH_SENSORS; s++) {
+            int32_t *level = &levels[(i % nodes) * BENCH_SENSORS + s];
+            int change = rand() % 8;
+            *level += change == 0 ? -1 : (change == 1 ? 1 : 0);
+            size += sensorsPutValue(payload + size, sensors[s], *level);
+        }
+        BenchPayload entry = { node, stream.size(), (uint8_t)size };
+        index.push_back(entry);
+        stream.insert(stream.end(), payload, payload + size);
+    }
+    printf("%zu payloads, %zu nodes, %zu bytes\n", payloads, nodes, stream.size());
+
+    SensorsDecoder decoder;
+    SensorsRecord records[16];
+    uint64_t decoded = 0;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < index.size(); i++) {
+        decoded += decoder.decode(index[i].node, &stream[index[i].offset], index[i].size, 0, records, 16);
+    }
+    double elapsed = seconds(begin);
+    printf("decode          %8.2f M records/s\n", decoded / elapsed / 1e6);
+
+    SensorsStore store;
+    if (!store.open(directory.c_str())) {
+        printf("Cannot open %s\n", directory.c_str());
+        return EXIT_FAILURE;
+    }
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < index.size(); i++) {
+        size_t count = decoder.decode(index[i].node, &stream[index[i].offset], index[i].size, 0, records, 16);
+        store.append(records, count);
+    }
+    elapsed = seconds(begin);
+    printf("decode + ingest %8.2f M records/s\n", decoded / elapsed / 1e6);
+    begin = std::chrono::steady_clock::now();
+    store.flush();
+    printf("flush           %8.3f s\n", seconds(begin));
+    printf("stored          %8.2f bytes/point in %llu blocks, %zu segments (raw %.2f bytes/record)\n",
+           (double)store.getBytes() / store.getPoints(), (unsigned long long)store.getBlocks(), store.getSegments(),
+           (double)stream.size() / decoded);
+
+    // One hour of every column, then all of every column
+    std::vector<int64_t> times;
+    std::vector<int32_t> values;
+    int64_t last = start + (payloads / nodes) * 60;
+    int64_t from = start + (last - start) / 2;
+    uint64_t found = 0;
+    begin = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < nodes; n++) {
+        for (uint8_t s = 0; s < BENCH_SENSORS; s++) {
+            times.clear();
+            values.clear();
+            found += store.scan(0x0013A20040000000ULL + n, sensors[s], from, from + 3600, &times, &values);
+        }
+    }
+    elapsed = seconds(begin);
+    printf("scan 1 h        %8.2f us/column, %llu points\n", elapsed * 1e6 / (nodes * BENCH_SENSORS), (unsigned long long)found);
+    found = 0;
+    begin = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < nodes; n++) {
+        for (uint8_t s = 0; s < BENCH_SENSORS; s++) {
+            times.clear();
+            values.clear();
+            found += store.scan(0x0013A20040000000ULL + n, sensors[s], start, last + 60, &times, &values);
+        }
+    }
+    elapsed = seconds(begin);
+    printf("scan all        %8.2f M points/s\n", found / elapsed / 1e6);
+
+    store.close();
+    begin = std::chrono::steady_clock::now();
+    store.open(directory.c_str());
+    printf("reopen          %8.3f s, %llu points\n", seconds(begin), (unsigned long long)store.getPoints());
+    store.close();
+    if (argc <= 3) {
+        removeDirectory(directory);
+    }
+    return found == decoded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -23,21 +23,53 @@ TSL2561 tsl(TSL2561_ADDR_FLOAT);
 #endif
 
 #ifdef Sensors_enableDHT
+#ifdef Sensors_captureDHT
+#ifdef __AVR__
+static_assert(digitalPinToInterrupt(DHTPIN) != NOT_AN_INTERRUPT, "Sensors_captureDHT needs DHTPIN on an interrupt pin");
+#endif
+SensorsDHT dht(DHTPIN);
+#else
 DHT dht(DHTPIN, DHTTYPE);
 #endif
+#endif
+
+#ifdef Sensors_enableBME
+SensorsBME bme;
+#endif
+
+#ifdef Sensors_boundedI2C
+SensorsI2C i2c;
+#endif
 
 #ifdef Sensors_enableBMP
+#ifdef Sensors_integerBMP
+SensorsBMP bmp;
+#else
 BMP180 bmp;
 #endif
+#endif
 
 void   Sensors::setup(uint8_t id)
 {
     _status = 0;
     _id = id;
+#ifdef Sensors_boundedI2C
+    i2c.begin();
+#endif
+#ifdef Sensors_snapshot
+    // Sensors known good before the restart are not probed again
+    restoreSnapshot();
+#endif
 #ifdef Sensors_enableRTC
     setSyncProvider(RTC.get);   // the function to get the time from the RTC
     if(timeStatus() != timeSet) {
         Serial.println("S:E01");
+        // A restored status must not keep a missing RTC
+#ifdef Sensors_temperatureRTC
+        bitClear(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT);
+        _temperatureRTC = SENSORS_VALUE_INVALID;
+#endif
+        bitClear(_status,SENSORS_TIME_SETUP_BIT);
     } else {
 #ifdef Sensors_temperatureRTC
         bitWrite(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT,true);
@@ -47,7 +79,7 @@ void   Sensors::setup(uint8_t id)
 #endif
 #ifdef Sensors_enableTSL
     //setTime(12,30,30,18,6,2015);
-    if (tsl.begin()) {
+    if (!bitRead(_status,SENSORS_LIGHT_SETUP_BIT) && tsl.begin()) {
         uint32_t lum = tsl.getFullLuminosity();
         if (lum != 0xffffffff) {
             bitWrite(_status,SENSORS_LIGHT_SETUP_BIT,true);
@@ -56,23 +88,39 @@ void   Sensors::setup(uint8_t id)
 #endif
     uint8_t setuprun = SENSORS_SETUP_RUNS;
     do {
-#ifdef Sensors_enableDHT
+#ifdef Sensors_captureDHT
+        if (!bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+            if (setuprun == SENSORS_SETUP_RUNS){
+                dht.begin();
+            }
+            delay(400); // Cold start delay (Uno)
+            if (dht.read()) {
+                loopCaptureDHT();
+                if (checkCenti(dht.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX) != SENSORS_VALUE_INVALID) {
+                    bitWrite(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT,true);
+                }
+                if (checkCenti(dht.getHumidity(), SENSORS_HUMIDITY_MIN, SENSORS_HUMIDITY_MAX) != SENSORS_VALUE_INVALID) {
+                    bitWrite(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT,true);
+                }
+            }
+        }
+#elif defined(Sensors_enableDHT)
         if (!bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
             if (setuprun == SENSORS_SETUP_RUNS){
                 dht.begin();
             }
             
             delay(400); // Cold start delay (Uno)
-            float temperatureDHT = dht.readTemperature();
-            if (!isnan(temperatureDHT)) {
+            int16_t temperatureDHT = toCenti(dht.readTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+            if (temperatureDHT != SENSORS_VALUE_INVALID) {
                 _temperatureDHT = temperatureDHT;
                 bitWrite(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT,true);
             }
         }
         if (!bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT)) {
             delay(400); // Cold start delay (Uno)
-            float humidityDHT = dht.readHumidity();
-            if (!isnan(humidityDHT) && !isnan(_temperatureDHT)) {
+            int16_t humidityDHT = toCenti(dht.readHumidity(), SENSORS_HUMIDITY_MIN, SENSORS_HUMIDITY_MAX);
+            if (humidityDHT != SENSORS_VALUE_INVALID && _temperatureDHT != SENSORS_VALUE_INVALID) {
                 _humidityDHT = humidityDHT;
                 bitWrite(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT,true);
             }
@@ -85,32 +133,47 @@ void   Sensors::setup(uint8_t id)
             }
         }
 #endif
-#ifdef Sensors_enableBMP
+#ifdef Sensors_integerBMP
+        // Only a read in this pass counts, never a restored value
+        if (!bitRead(_status,SENSORS_BMP_SETUP_BIT) && bmp.begin() && loopBMP()) {
+#ifdef Sensors_temperatureBMP
+            if (checkCenti(bmp.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX) != SENSORS_VALUE_INVALID) {
+                bitWrite(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT,true);
+            }
+#endif
+            bitWrite(_status,SENSORS_BMP_SETUP_BIT,true);
+        }
+#elif defined(Sensors_enableBMP)
         if (setuprun == SENSORS_SETUP_RUNS){
             bmp.begin(BMP180_Mode_HighResolution,false);
         }
         if (!bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
+            int16_t temperatureBMP = toCenti(bmp.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+            if (temperatureBMP != SENSORS_VALUE_INVALID) {
 #ifdef Sensors_temperatureBMP
-            float temperatureBMP = bmp.getTemperature();
-            if (!isnan(temperatureBMP)) {
                 _temperatureBMP = temperatureBMP;
-                bitWrite(_status,SENSORS_BMP_SETUP_BIT,true);
                 bitWrite(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT,true);
-            }
-#else
-            float temperatureBMP = bmp.getTemperature();
-            if (!isnan(temperatureBMP)) {
-                _temperatureBMP = temperatureBMP;
+#endif
                 bitWrite(_status,SENSORS_BMP_SETUP_BIT,true);
             }
+        }
 #endif
+#ifdef Sensors_enableBME
+        if (!bitRead(_status,SENSORS_BME_SETUP_BIT) && bme.begin() && loopBME()) {
+            bitWrite(_status,SENSORS_BME_SETUP_BIT,true);
         }
 #endif
     } while (setuprun-- > 0);
+#ifdef Sensors_temperatureFusion
+    loopTemperature();
+#endif
     bitWrite(_status,SENSORS_STATUS_SETUP_BIT,true);
 #ifdef Sensors_reset
     _save = _status;
 #endif
+#ifdef Sensors_snapshot
+    saveSetup();
+#endif
 }
 
 bool Sensors::isSetup()
@@ -123,16 +186,35 @@ void Sensors::loop(Relays *relays)
 {
     loop();
     if (relays->isSetup()) {
+#ifdef Sensors_temperatureFusion
+        if (_temperature != SENSORS_VALUE_INVALID) {
+            relays->setTemperature((float)_temperature / SENSORS_FLOAT_TO_INT_MULTIPLY);
+        }
+#endif
 #ifdef Sensors_enableDHT
-        if (bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
-            relays->setTemperature(_temperatureDHT);
+#ifndef Sensors_temperatureFusion
+        if (bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT) && _temperatureDHT != SENSORS_VALUE_INVALID) {
+            relays->setTemperature(getTemperature());
         }
+#endif
 #ifdef RelayTask_Humidity
-        if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
-            relays->setHumidity(_humidityDHT);
+        if (bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT) && _humidityDHT != SENSORS_VALUE_INVALID) {
+            relays->setHumidity(getHumidity());
         }
 #endif RelayTask_Humidity
 #endif Sensors_enableDHT
+#ifdef Sensors_enableBME
+#ifndef Sensors_temperatureFusion
+        if (!bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT) && bitRead(_status,SENSORS_BME_SETUP_BIT) && _temperatureBME != SENSORS_VALUE_INVALID) {
+            relays->setTemperature((float)_temperatureBME / SENSORS_FLOAT_TO_INT_MULTIPLY);
+        }
+#endif
+#ifdef RelayTask_Humidity
+        if (!bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT) && bitRead(_status,SENSORS_BME_SETUP_BIT) && _humidityBME != SENSORS_VALUE_INVALID) {
+            relays->setHumidity((float)_humidityBME / SENSORS_FLOAT_TO_INT_MULTIPLY);
+        }
+#endif RelayTask_Humidity
+#endif Sensors_enableBME
 #ifdef Sensors_enableTSL
         if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
             relays->setLight(min(min(_ir,_lux),_visible));
@@ -142,24 +224,54 @@ void Sensors::loop(Relays *relays)
 }
 #endif Sensors_Relays
 
+#if defined(Sensors_xbee) && defined(Sensors_alarms)
+// Alarms go out in their own frame as soon as one is free
+void Sensors::loop(XBeeQueue *queue)
+{
+    loop();
+    if (hasAlarms() && !queue->isFull()) {
+        XBeeFrame *frame = queue->acquire();
+        if (frame != NULL) {
+            putXBeeAlarms(frame);
+            queue->commit();
+        }
+    }
+    queue->update();
+}
+#endif
+
 void Sensors::loop()
 {
+#ifdef Sensors_captureDHT
+    dht.update();
+#endif
     unsigned long m_seconds = millis();
     if (_last_run < m_seconds) {
 #ifdef Sensors_debug
         Serial.println("S:l");
+#endif
+        bool bus = true;
+#ifdef Sensors_boundedI2C
+        bus = i2c.check();
 #endif
 #ifdef Sensors_enableRTC
-        if ( bitRead(_status,SENSORS_TIME_SETUP_BIT)) {
+        if (bus && bitRead(_status,SENSORS_TIME_SETUP_BIT)) {
             loopTime();
         }
 #ifdef Sensors_temperatureRTC
-        if (_looper%8==1 && bitRead(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT)) {
+        if (bus && _looper%8==1 && bitRead(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT)) {
             loopTemperatureRTC();
         }
 #endif
 #endif
-#ifdef Sensors_enableDHT
+#ifdef Sensors_captureDHT
+        if (_looper%8==2 && bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+            dht.start();
+        }
+        if (_looper%8==4 && bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+            loopCaptureDHT();
+        }
+#elif defined(Sensors_enableDHT)
         if (_looper%8==2 && bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
             loopTemperatureDHT();
         }
@@ -168,7 +280,7 @@ void Sensors::loop()
         }
 #endif
 #ifdef Sensors_enableTSL
-        if (_looper%8==3 && bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
+        if (bus && _looper%8==3 && bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
             loopLight();
         }
 #endif
@@ -178,25 +290,383 @@ void Sensors::loop()
         }
 #endif
 #ifdef Sensors_enableBMP
-        if (_looper%8==6 && bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
+        if (bus && _looper%8==6 && bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
             loopBMP();
         }
 #endif
+#ifdef Sensors_enableBME
+        if (bus && _looper%8==0 && bitRead(_status,SENSORS_BME_SETUP_BIT)) {
+            loopBME();
+        }
+#endif
+#ifdef Sensors_temperatureFusion
+        if (_looper%8==7) {
+            loopTemperature();
+        }
+#endif
+#ifdef Sensors_boundedI2C
+        i2c.timedOut();
+#endif
+#ifdef Sensors_alarms
+        loopAlarms();
+#endif
+#ifdef Sensors_snapshot
+        if (_looper%8==7) {
+            _stale = false;
+        }
+        loopSnapshot();
+#endif
 #ifdef Sensors_print
         if (_looper%15==0 && _looper > 10) {
             printStatus();
         }
 #endif
-        _last_run += SENSORS_LOOP_CHECK;
+        _last_run += _interval;
         _looper++;
 #ifdef Sensors_reset
         if (_status != _save ) {
+#ifdef Sensors_snapshot
+            saveSnapshot();
+#endif
             reset();
         }
 #endif
     }
 }
 
+#ifdef Sensors_snapshot
+// 0xFF minus the 8 bit sum, as in XBee frames
+static uint8_t sensorsChecksum(const uint8_t *data, uint8_t length)
+{
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return 0xFF - sum;
+}
+
+// EEPROM cells wear out, only bytes that changed are written
+static void sensorsUpdate(int address, uint8_t value)
+{
+    if (EEPROM.read(address) != value) {
+        EEPROM.write(address, value);
+    }
+}
+
+static void sensorsWrite(int address, const uint8_t *data, uint8_t length)
+{
+    for (uint8_t i = 0; i < length; i++) {
+        sensorsUpdate(address + i, data[i]);
+    }
+    sensorsUpdate(address + length, sensorsChecksum(data, length));
+}
+
+static bool sensorsRead(int address, uint8_t *data, uint8_t length)
+{
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = EEPROM.read(address + i);
+    }
+    return EEPROM.read(address + length) == sensorsChecksum(data, length);
+}
+
+    // Blocking, for the path to reset(). Each changed byte takes ~3.3 ms.
+    bool Sensors::saveSnapshot()
+    {
+        if (!isSetup()) {
+            return false;
+        }
+        saveSetup();
+        getReadings(&_readings);
+        sensorsWrite(SENSORS_READINGS_ADDRESS, (const uint8_t *)&_readings, sizeof(_readings));
+        _snapshotByte = SENSORS_SNAPSHOT_IDLE;
+        _snapshotTicks = 0;
+        return true;
+    }
+
+    // The next setup() probes every sensor again
+    void Sensors::clearSnapshot()
+    {
+        sensorsUpdate(SENSORS_SNAPSHOT_ADDRESS, ~SENSORS_SNAPSHOT_MAGIC);
+    }
+
+    bool Sensors::isStale()
+    {
+        return _stale;
+    }
+
+// Sensors that passed setup and their calibration. Normally the same
+// bytes as before, so nothing is written.
+void Sensors::saveSetup()
+{
+    SensorsSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.magic = SENSORS_SNAPSHOT_MAGIC;
+    snapshot.size = sizeof(snapshot);
+    snapshot.status = _status;
+#ifdef Sensors_temperatureFusion
+    memcpy(snapshot.temperatureOffset, _temperatureOffset, sizeof(_temperatureOffset));
+    memcpy(snapshot.temperatureGain, _temperatureGain, sizeof(_temperatureGain));
+    memcpy(snapshot.temperatureWeight, _temperatureWeight, sizeof(_temperatureWeight));
+#endif
+#ifdef Sensors_integerBMP
+    bmp.getCalibration(snapshot.calibrationBMP);
+#endif
+#ifdef Sensors_enableBME
+    bme.getCalibration(snapshot.calibrationBME);
+#endif
+    sensorsWrite(SENSORS_SNAPSHOT_ADDRESS, (const uint8_t *)&snapshot, sizeof(snapshot));
+}
+
+// Readings go out one EEPROM byte per loop, so a save never stalls the
+// loop for more than one write. A reset halfway leaves a bad checksum
+// and only the readings are lost.
+void Sensors::loopSnapshot()
+{
+    if (_snapshotByte == SENSORS_SNAPSHOT_IDLE) {
+        if (++_snapshotTicks < SENSORS_SNAPSHOT_TICKS) {
+            return;
+        }
+        _snapshotTicks = 0;
+        getReadings(&_readings);
+        _snapshotByte = 0;
+    }
+    const uint8_t *data = (const uint8_t *)&_readings;
+    if (_snapshotByte < sizeof(_readings)) {
+        sensorsUpdate(SENSORS_READINGS_ADDRESS + _snapshotByte, data[_snapshotByte]);
+        _snapshotByte++;
+    } else {
+        sensorsUpdate(SENSORS_READINGS_ADDRESS + sizeof(_readings), sensorsChecksum(data, sizeof(_readings)));
+        _snapshotByte = SENSORS_SNAPSHOT_IDLE;
+    }
+}
+
+void Sensors::getReadings(SensorsReadings *readings)
+{
+    memset(readings, 0, sizeof(SensorsReadings));
+    readings->magic = SENSORS_SNAPSHOT_MAGIC;
+#ifdef Sensors_enableRTC
+#ifdef Sensors_temperatureRTC
+    readings->temperatureRTC = _temperatureRTC;
+#endif
+#endif
+    readings->temperatureDHT = _temperatureDHT;
+    readings->humidityDHT = _humidityDHT;
+#ifdef Sensors_temperatureBMP
+    readings->temperatureBMP = _temperatureBMP;
+#endif
+#ifdef Sensors_dewPoint
+    readings->dewpoint = _dewpoint;
+#endif
+#ifdef Sensors_enableBMP
+    readings->pressure = _pressure;
+#ifdef Sensors_seaLevelBMP
+    readings->seaLevel = _seaLevel;
+#endif
+#ifdef Sensors_altitudeBMP
+    readings->altitude = _altitude;
+#endif
+#endif
+#ifdef Sensors_enableBME
+    readings->temperatureBME = _temperatureBME;
+    readings->humidityBME = _humidityBME;
+    readings->pressureBME = _pressureBME;
+#endif
+#ifdef Sensors_enableTSL
+    readings->lux = _lux;
+    readings->ir = _ir;
+    readings->visible = _visible;
+    readings->full = _full;
+#endif
+}
+
+void Sensors::setReadings(const SensorsReadings *readings)
+{
+#ifdef Sensors_enableRTC
+#ifdef Sensors_temperatureRTC
+    _temperatureRTC = readings->temperatureRTC;
+#endif
+#endif
+    _temperatureDHT = readings->temperatureDHT;
+    _humidityDHT = readings->humidityDHT;
+#ifdef Sensors_temperatureBMP
+    _temperatureBMP = readings->temperatureBMP;
+#endif
+#ifdef Sensors_dewPoint
+    _dewpoint = readings->dewpoint;
+#endif
+#ifdef Sensors_enableBMP
+    _pressure = readings->pressure;
+#ifdef Sensors_seaLevelBMP
+    _seaLevel = readings->seaLevel;
+#endif
+#ifdef Sensors_altitudeBMP
+    _altitude = readings->altitude;
+#endif
+#endif
+#ifdef Sensors_enableBME
+    _temperatureBME = readings->temperatureBME;
+    _humidityBME = readings->humidityBME;
+    _pressureBME = readings->pressureBME;
+#endif
+#ifdef Sensors_enableTSL
+    _lux = readings->lux;
+    _ir = readings->ir;
+    _visible = readings->visible;
+    _full = readings->full;
+#endif
+}
+
+// Restores the sensor status and resumes the drivers of the sensors that
+// were good, a driver that does not answer is left for the normal probe.
+// The readings are restored when their own block is valid.
+bool Sensors::restoreSnapshot()
+{
+    SensorsSnapshot snapshot;
+    if (!sensorsRead(SENSORS_SNAPSHOT_ADDRESS, (uint8_t *)&snapshot, sizeof(snapshot))
+        || snapshot.magic != SENSORS_SNAPSHOT_MAGIC || snapshot.size != sizeof(snapshot)) {
+        return false;
+    }
+    _status = snapshot.status;
+    bitClear(_status,SENSORS_STATUS_SETUP_BIT);
+#ifdef Sensors_enableDHT
+    if (bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+        dht.begin();
+    }
+#endif
+#ifdef Sensors_enableTSL
+    if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT) && !tsl.begin()) {
+        bitClear(_status,SENSORS_LIGHT_SETUP_BIT);
+    }
+#endif
+#ifdef Sensors_integerBMP
+    if (bitRead(_status,SENSORS_BMP_SETUP_BIT) && !bmp.begin(snapshot.calibrationBMP)) {
+        bitClear(_status,SENSORS_BMP_SETUP_BIT);
+#ifdef Sensors_temperatureBMP
+        bitClear(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT);
+#endif
+    }
+#endif
+#ifdef Sensors_enableBME
+    if (bitRead(_status,SENSORS_BME_SETUP_BIT) && !bme.begin(snapshot.calibrationBME)) {
+        bitClear(_status,SENSORS_BME_SETUP_BIT);
+    }
+#endif
+#ifdef Sensors_temperatureFusion
+    memcpy(_temperatureOffset, snapshot.temperatureOffset, sizeof(_temperatureOffset));
+    memcpy(_temperatureGain, snapshot.temperatureGain, sizeof(_temperatureGain));
+    memcpy(_temperatureWeight, snapshot.temperatureWeight, sizeof(_temperatureWeight));
+#endif
+    if (sensorsRead(SENSORS_READINGS_ADDRESS, (uint8_t *)&_readings, sizeof(_readings))
+        && _readings.magic == SENSORS_SNAPSHOT_MAGIC) {
+        setReadings(&_readings);
+        dropReadings();
+        _stale = true;
+    }
+    return true;
+}
+
+// Readings restored for a sensor that did not resume are not reported,
+// the sensor has to pass the normal probe first
+void Sensors::dropReadings()
+{
+#ifdef Sensors_enableRTC
+#ifdef Sensors_temperatureRTC
+    if (!bitRead(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT)) {
+        _temperatureRTC = SENSORS_VALUE_INVALID;
+    }
+#endif
+#endif
+    if (!bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+        _temperatureDHT = SENSORS_VALUE_INVALID;
+    }
+    if (!bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT)) {
+        _humidityDHT = SENSORS_VALUE_INVALID;
+    }
+#ifdef Sensors_dewPoint
+    if (!bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT) || !bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT)) {
+        _dewpoint = SENSORS_VALUE_INVALID;
+    }
+#endif
+#ifdef Sensors_enableTSL
+    if (!bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
+        _lux = 0;
+        _ir = 0;
+        _visible = 0;
+        _full = 0;
+    }
+#endif
+#ifdef Sensors_enableBMP
+    if (!bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
+        _pressure = 0;
+#ifdef Sensors_seaLevelBMP
+        _seaLevel = 0;
+#endif
+#ifdef Sensors_altitudeBMP
+        _altitude = 0;
+#endif
+    }
+#endif
+#ifdef Sensors_temperatureBMP
+    if (!bitRead(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT)) {
+        _temperatureBMP = SENSORS_VALUE_INVALID;
+    }
+#endif
+#ifdef Sensors_enableBME
+    if (!bitRead(_status,SENSORS_BME_SETUP_BIT)) {
+        _temperatureBME = SENSORS_VALUE_INVALID;
+        _humidityBME = SENSORS_VALUE_INVALID;
+        _pressureBME = 0;
+    }
+#endif
+}
+#endif Sensors_snapshot
+
+#ifdef Sensors_boundedI2C
+    uint8_t Sensors::getI2CFaults()
+    {
+        return i2c.getFaults();
+    }
+#endif
+
+#ifdef Sensors_alarms
+    bool Sensors::addAlarm(uint8_t channel, uint8_t flags, long threshold, long hysteresis, long rate)
+    {
+        uint8_t direction = flags & (SENSORS_ALARM_ABOVE | SENSORS_ALARM_BELOW);
+        if (_alarmCount >= SENSORS_ALARMS || channel >= SENSORS_CHANNELS) {
+            return false;
+        }
+        // Exactly one of SENSORS_ALARM_ABOVE and SENSORS_ALARM_BELOW
+        if (direction != SENSORS_ALARM_ABOVE && direction != SENSORS_ALARM_BELOW) {
+            return false;
+        }
+        SensorsAlarm *alarm = &_alarms[_alarmCount++];
+        alarm->channel = channel;
+        alarm->flags = direction;
+        alarm->pending = SENSORS_ALARM_NONE;
+        alarm->threshold = threshold;
+        alarm->hysteresis = hysteresis;
+        alarm->rate = rate;
+        alarm->last = 0;
+        alarm->sampled = false;
+        return true;
+    }
+
+    void Sensors::clearAlarms()
+    {
+        _alarmCount = 0;
+    }
+
+    bool Sensors::hasAlarms()
+    {
+        for (uint8_t i = 0; i < _alarmCount; i++) {
+            if (_alarms[i].pending != SENSORS_ALARM_NONE) {
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
+
 #ifdef Sensors_enableRTC
     time_t Sensors::getTime()
     {
@@ -207,23 +677,95 @@ void Sensors::loop()
 #ifdef Sensors_enableDHT
     float Sensors::getTemperature()
     {
-        return _temperatureDHT;
+        if (_temperatureDHT == SENSORS_VALUE_INVALID) {
+            return NAN;
+        }
+        return (float)_temperatureDHT / SENSORS_FLOAT_TO_INT_MULTIPLY;
     }
 
     float Sensors::getHumidity()
+    {
+        if (_humidityDHT == SENSORS_VALUE_INVALID) {
+            return NAN;
+        }
+        return (float)_humidityDHT / SENSORS_FLOAT_TO_INT_MULTIPLY;
+    }
+
+    int16_t Sensors::getTemperatureCenti()
+    {
+        return _temperatureDHT;
+    }
+
+    int16_t Sensors::getHumidityCenti()
     {
         return _humidityDHT;
     }
 #endif
 
+#ifdef Sensors_temperatureFusion
+    int16_t Sensors::getFusedTemperature()
+    {
+        return _temperature;
+    }
+
+    int16_t Sensors::getTemperatureSpread()
+    {
+        return _temperatureSpread;
+    }
+
+    void Sensors::setTemperatureCalibration(uint8_t source, int16_t offset, uint16_t gain, uint8_t weight)
+    {
+        if (source >= SENSORS_TEMPERATURE_SOURCES) {
+            return;
+        }
+        _temperatureOffset[source] = offset;
+        _temperatureGain[source] = gain;
+        _temperatureWeight[source] = weight;
+#ifdef Sensors_snapshot
+        if (isSetup()) {
+            saveSetup();
+        }
+#endif
+    }
+#endif
+
 #ifdef Sensors_enableBMP
     long Sensors::getPressure()
     {
         return _pressure;
     }
+#ifdef Sensors_seaLevelBMP
+    long Sensors::getSeaLevelPressure()
+    {
+        return _seaLevel;
+    }
+#endif
+#ifdef Sensors_altitudeBMP
+    long Sensors::getAltitude()
+    {
+        return _altitude;
+    }
+#endif
 
 #endif
 
+#ifdef Sensors_enableBME
+    int16_t Sensors::getTemperatureBME()
+    {
+        return _temperatureBME;
+    }
+
+    int16_t Sensors::getHumidityBME()
+    {
+        return _humidityBME;
+    }
+
+    long Sensors::getPressureBME()
+    {
+        return _pressureBME;
+    }
+#endif
+
 #ifdef Sensors_enableTSL
     uint16_t Sensors::getLux()
     {
@@ -237,134 +779,417 @@ void Sensors::loop()
     {
         return _visible;
     }
-    uint16_t Sensors::getFull()
-    {
-        return _full;
+    uint16_t Sensors::getFull()
+    {
+        return _full;
+    }
+#endif
+
+
+#ifdef Sensors_xbee
+
+template <class Buffer>
+uint8_t Sensors::putXBeeData(Buffer *buffer, uint32_t channels)
+{
+#ifdef Sensors_reset
+    if (_status != _save ) {
+#ifdef Sensors_snapshot
+        saveSnapshot();
+#endif
+        reset();
+    }
+#endif
+    uint8_t records = 0;
+    // The cursor only continues the snapshot of the same channels
+    if (channels != _cursorChannels) {
+        _cursor = 0;
+        _cursorChannels = channels;
+        _partial = false;
+    }
+#ifdef Sensors_snapshot
+    if (_stale && buffer->getFreeSize() >= XBEE_STALE_RECORD_SIZE) {
+        buffer->put(XBEE_STALE_HEADER);
+    }
+#endif
+    // A continued snapshot starts with the time again
+    if (_partial && bitRead(channels, SENSORS_CHANNEL_TIME)) {
+        if (putXBeeChannel(buffer, SENSORS_CHANNEL_TIME) == SENSORS_RECORD_WRITTEN) {
+            records++;
+        }
+        bitClear(channels, SENSORS_CHANNEL_TIME);
+    }
+    while (_cursor < SENSORS_CHANNELS) {
+        uint8_t channel = _priority[_cursor];
+        if (bitRead(channels, channel)) {
+            uint8_t result = putXBeeChannel(buffer, channel);
+            if (result == SENSORS_RECORD_FULL) {
+                _partial = true;
+                return records;
+            }
+            if (result == SENSORS_RECORD_WRITTEN) {
+                records++;
+            }
+        }
+        _cursor++;
+    }
+    _cursor = 0;
+    _partial = false;
+    return records;
+}
+
+#ifdef Sensors_alarms
+// Time, then per pending alarm: XBEE_ALARM_HEADER, channel, the event
+// bits since the last record with SENSORS_ALARM_ACTIVE for the current
+// state, and the normal record of the channel. Alarms that do not fit
+// stay pending.
+template <class Buffer>
+uint8_t Sensors::putXBeeAlarms(Buffer *buffer)
+{
+    uint8_t records = 0;
+    if (!hasAlarms()) {
+        return records;
+    }
+    if (putXBeeChannel(buffer, SENSORS_CHANNEL_TIME) == SENSORS_RECORD_WRITTEN) {
+        records++;
+    }
+    for (uint8_t i = 0; i < _alarmCount; i++) {
+        SensorsAlarm *alarm = &_alarms[i];
+        if (alarm->pending == SENSORS_ALARM_NONE) {
+            continue;
+        }
+        if (buffer->getFreeSize() < XBEE_ALARM_RECORD_SIZE + XBEE_LONG_RECORD_SIZE) {
+            break;
+        }
+        buffer->put(XBEE_ALARM_HEADER);
+        buffer->put(alarm->channel);
+        buffer->put(alarm->pending | (alarm->flags & SENSORS_ALARM_ACTIVE));
+        putXBeeChannel(buffer, alarm->channel);
+        alarm->pending = SENSORS_ALARM_NONE;
+        records++;
+    }
+    return records;
+}
+#endif
+
+// The cursor alone cannot tell: it is still 0 when the first record did
+// not fit
+bool Sensors::isXBeeComplete()
+{
+    return !_partial;
+}
+
+// Channels in the given order go first, the rest keep their order
+void Sensors::setXBeePriority(const uint8_t *channels, uint8_t count)
+{
+    uint32_t listed = 0;
+    uint8_t next = 0;
+    // A channel listed twice keeps its first place, the slots must hold
+    // every channel once
+    for (uint8_t i = 0; i < count && next < SENSORS_CHANNELS; i++) {
+        if (channels[i] < SENSORS_CHANNELS && !bitRead(listed, channels[i])) {
+            bitSet(listed, channels[i]);
+            _priority[next++] = channels[i];
+        }
+    }
+    for (uint8_t channel = 0; channel < SENSORS_CHANNELS && next < SENSORS_CHANNELS; channel++) {
+        if (!bitRead(listed, channel)) {
+            _priority[next++] = channel;
+        }
+    }
+    _cursor = 0;
+    _partial = false;
+}
+
+// Encode into the free frame of the queue, false when both frames are
+// still waiting for the serial (call queue->update() from loop())
+bool Sensors::queueXBeeData(XBeeQueue *queue, uint32_t channels)
+{
+    if (queue->isFull()) {
+        queue->drop();
+        return false;
+    }
+    XBeeFrame *frame = queue->acquire();
+    putXBeeData(frame, channels);
+    return queue->commit();
+}
+
+// Request: XBEE_REQUEST_HEADER, channel mask bits 0-15 (2 bytes), optional loop tick
+// in ms (2 bytes), optional channel mask bits 16-31 (2 bytes).
+// Returns the records written, 0 for an invalid request. A reply that
+// does not fit continues when the same request is passed again while
+// isXBeeComplete() is false.
+template <class Buffer>
+uint8_t Sensors::putXBeeRequest(const uint8_t *request, uint8_t length, Buffer *buffer)
+{
+    if (length < 3 || request[0] != XBEE_REQUEST_HEADER) {
+        return 0;
+    }
+    uint32_t channels = ((uint16_t)request[1] << 8) | request[2];
+    if (length >= 5) {
+        uint16_t interval = ((uint16_t)request[3] << 8) | request[4];
+        if (interval > 0) {
+            _interval = interval;
+        }
+    }
+    if (length >= 7) {
+        channels |= ((uint32_t)request[5] << 24) | ((uint32_t)request[6] << 16);
+    }
+    if (channels == 0) {
+        return 0;
     }
-#endif
-
-
-#ifdef Sensors_xbee
+    return putXBeeData(buffer, channels);
+}
 
-uint8_t Sensors::putXBeeData(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeChannel(Buffer *buffer, uint8_t channel)
 {
-#ifdef Sensors_reset
-    if (_status != _save ) {
-        reset();
-    }
-#endif
+    switch (channel) {
 #ifdef Sensors_enableRTC
-    if ( bitRead(_status,SENSORS_TIME_SETUP_BIT)) {
-        putXBeeTime(buffer);
-    }
+        case SENSORS_CHANNEL_TIME:
+            if (bitRead(_status,SENSORS_TIME_SETUP_BIT)) {
+                return putXBeeTime(buffer);
+            }
+            break;
 #ifdef Sensors_temperatureRTC
-    if (bitRead(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT)) {
-        putXBeeTemperatureRTC(buffer);
-    }
+        case SENSORS_CHANNEL_TEMPERATURE_RTC:
+            if (bitRead(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT)) {
+                return putXBeeTemperatureRTC(buffer);
+            }
+            break;
 #endif
 #endif
 #ifdef Sensors_enableDHT
-    if (bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
-        putXBeeTemperatureDHT(buffer);
-    }
-    if (bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT)) {
-        putXBeeHumidityDHT(buffer);
-    }
+        case SENSORS_CHANNEL_TEMPERATURE_DHT:
+            if (bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+                return putXBeeTemperatureDHT(buffer);
+            }
+            break;
+        case SENSORS_CHANNEL_HUMIDITY_DHT:
+            if (bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT)) {
+                return putXBeeHumidityDHT(buffer);
+            }
+            break;
 #endif
 #ifdef Sensors_enableTSL
-    if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
-        putXBeeLux(buffer);
-        putXBeeIr(buffer);
-        putXBeeVisible(buffer);
-        putXBeeFull(buffer);
-    }
+        case SENSORS_CHANNEL_LUX:
+            if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
+                return putXBeeLux(buffer);
+            }
+            break;
+        case SENSORS_CHANNEL_IR:
+            if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
+                return putXBeeIr(buffer);
+            }
+            break;
+        case SENSORS_CHANNEL_VISIBLE:
+            if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
+                return putXBeeVisible(buffer);
+            }
+            break;
+        case SENSORS_CHANNEL_FULL:
+            if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
+                return putXBeeFull(buffer);
+            }
+            break;
 #endif
 #ifdef Sensors_enableBMP
-    if (bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
 #ifdef Sensors_temperatureBMP
-        if (bitRead(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT)) {
-            putXBeeTemperatureBMP(buffer);
-        }
+        case SENSORS_CHANNEL_TEMPERATURE_BMP:
+            if (bitRead(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT)) {
+                return putXBeeTemperatureBMP(buffer);
+            }
+            break;
 #endif
-        putXBeePressure(buffer);
-    }
+        case SENSORS_CHANNEL_PRESSURE:
+            if (bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
+                return putXBeePressure(buffer);
+            }
+            break;
+#ifdef Sensors_seaLevelBMP
+        case SENSORS_CHANNEL_SEA_LEVEL:
+            if (bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
+                return putXBeeSeaLevelPressure(buffer);
+            }
+            break;
+#endif
+#ifdef Sensors_altitudeBMP
+        case SENSORS_CHANNEL_ALTITUDE:
+            if (bitRead(_status,SENSORS_BMP_SETUP_BIT)) {
+                return putXBeeAltitude(buffer);
+            }
+            break;
+#endif
+#endif
+#ifdef Sensors_enableBME
+        case SENSORS_CHANNEL_TEMPERATURE_BME:
+            if (bitRead(_status,SENSORS_BME_SETUP_BIT)) {
+                return putXBeeTemperatureBME(buffer);
+            }
+            break;
+        case SENSORS_CHANNEL_HUMIDITY_BME:
+            if (bitRead(_status,SENSORS_BME_SETUP_BIT)) {
+                return putXBeeHumidityBME(buffer);
+            }
+            break;
+        case SENSORS_CHANNEL_PRESSURE_BME:
+            if (bitRead(_status,SENSORS_BME_SETUP_BIT)) {
+                return putXBeePressureBME(buffer);
+            }
+            break;
+#endif
+#ifdef Sensors_temperatureFusion
+        case SENSORS_CHANNEL_TEMPERATURE:
+            return putXBeeFusedTemperature(buffer);
+            break;
+        case SENSORS_CHANNEL_TEMPERATURE_SPREAD:
+            return putXBeeTemperatureSpread(buffer);
+            break;
 #endif
 #ifdef Sensors_dewPoint
-    if (bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT) && bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
-        putXBeeDewPoint(buffer);
-    }
+        case SENSORS_CHANNEL_DEWPOINT:
+            if (bitRead(_status,SENSORS_HUMIDITY_DHT_SETUP_BIT) && bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+                return putXBeeDewPoint(buffer);
+            }
+            break;
 #endif
-    return 0;
+        default:
+            break;
+    }
+    return SENSORS_RECORD_SKIPPED;
 }
 
 #ifdef Sensors_enableRTC
-void Sensors::putXBeeTime(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeTime(Buffer *buffer)
 {
-    if (buffer->getFreeSize() >= 5) {
-        buffer->put(XBEE_TIME_HEADER);
-        buffer->putTime(_lastTime);
+    if (buffer->getFreeSize() < XBEE_TIME_RECORD_SIZE) {
+        return SENSORS_RECORD_FULL;
     }
+    buffer->put(XBEE_TIME_HEADER);
+    buffer->putTime(_lastTime);
+    return SENSORS_RECORD_WRITTEN;
 }
 
 #ifdef Sensors_temperatureRTC
-void Sensors::putXBeeTemperatureRTC(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeTemperatureRTC(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x01, (int)_temperatureRTC*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x01, _temperatureRTC);
 }
 #endif
 #endif
 
 #ifdef Sensors_enableDHT
-void Sensors::putXBeeTemperatureDHT(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeTemperatureDHT(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x02, _temperatureDHT*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x02, _temperatureDHT);
 }
 
-void Sensors::putXBeeHumidityDHT(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeHumidityDHT(Buffer *buffer)
 {
-    return putXBeeInt(buffer, XBEE_HUMIDITY_HEADER | 0x01, _humidityDHT*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeInt(buffer, XBEE_HUMIDITY_HEADER | 0x01, _humidityDHT);
 }
 #endif
 
 #ifdef Sensors_enableTSL
-void Sensors::putXBeeLux(ByteBuffer *buffer)
+// Sensor 0x02: the x100 value no longer fits an int, so it is sent as a
+// long. A gateway that only knows sensor 0x01 sees an unknown id
+// instead of reading the wrong length.
+template <class Buffer>
+uint8_t Sensors::putXBeeLux(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_LUX_HEADER | 0x01, _lux*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeLong(buffer, XBEE_LUX_HEADER | 0x02, (long)_lux*SENSORS_FLOAT_TO_INT_MULTIPLY);
 }
 
-void Sensors::putXBeeIr(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeIr(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_IR_HEADER | 0x01, _ir*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeLong(buffer, XBEE_IR_HEADER | 0x02, (long)_ir*SENSORS_FLOAT_TO_INT_MULTIPLY);
 }
 
-void Sensors::putXBeeVisible(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeVisible(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_VISIBLE_HEADER | 0x01, _visible*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeLong(buffer, XBEE_VISIBLE_HEADER | 0x02, (long)_visible*SENSORS_FLOAT_TO_INT_MULTIPLY);
 }
 
-void Sensors::putXBeeFull(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeFull(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_FULL_HEADER | 0x01, _full*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeLong(buffer, XBEE_FULL_HEADER | 0x02, (long)_full*SENSORS_FLOAT_TO_INT_MULTIPLY);
 }
 #endif
 
 #ifdef Sensors_enableBMP
 #ifdef Sensors_temperatureBMP
-void Sensors::putXBeeTemperatureBMP(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeTemperatureBMP(Buffer *buffer)
+{
+    return putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x03, _temperatureBMP);
+}
+#endif
+template <class Buffer>
+uint8_t Sensors::putXBeePressure(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x03, _temperatureBMP*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeLong(buffer, XBEE_PRESSURE_HEADER | 0x01, (long)_pressure);
+}
+#ifdef Sensors_seaLevelBMP
+template <class Buffer>
+uint8_t Sensors::putXBeeSeaLevelPressure(Buffer *buffer)
+{
+    return putXBeeLong(buffer, XBEE_PRESSURE_HEADER | 0x02, _seaLevel);
 }
 #endif
-void Sensors::putXBeePressure(ByteBuffer *buffer)
+#ifdef Sensors_altitudeBMP
+template <class Buffer>
+uint8_t Sensors::putXBeeAltitude(Buffer *buffer)
 {
-    putXBeeLong(buffer, XBEE_PRESSURE_HEADER | 0x01, (long)_pressure);
+    return putXBeeLong(buffer, XBEE_ALTITUDE_HEADER | 0x01, _altitude);
 }
 #endif
+#endif
 
 #ifdef Sensors_dewPoint
-void Sensors::putXBeeDewPoint(ByteBuffer *buffer)
+template <class Buffer>
+uint8_t Sensors::putXBeeDewPoint(Buffer *buffer)
+{
+    return putXBeeInt(buffer, XBEE_DEWPOINT_HEADER | 0x01, _dewpoint);
+}
+#endif
+
+#ifdef Sensors_enableBME
+template <class Buffer>
+uint8_t Sensors::putXBeeTemperatureBME(Buffer *buffer)
+{
+    return putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x06, _temperatureBME);
+}
+
+template <class Buffer>
+uint8_t Sensors::putXBeeHumidityBME(Buffer *buffer)
+{
+    return putXBeeInt(buffer, XBEE_HUMIDITY_HEADER | 0x02, _humidityBME);
+}
+
+template <class Buffer>
+uint8_t Sensors::putXBeePressureBME(Buffer *buffer)
+{
+    return putXBeeLong(buffer, XBEE_PRESSURE_HEADER | 0x03, _pressureBME);
+}
+#endif
+
+#ifdef Sensors_temperatureFusion
+template <class Buffer>
+uint8_t Sensors::putXBeeFusedTemperature(Buffer *buffer)
+{
+    return putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x04, _temperature);
+}
+
+template <class Buffer>
+uint8_t Sensors::putXBeeTemperatureSpread(Buffer *buffer)
 {
-    putXBeeInt(buffer, XBEE_DEWPOINT_HEADER | 0x01, _dewpoint*SENSORS_FLOAT_TO_INT_MULTIPLY);
+    return putXBeeInt(buffer, XBEE_TEMPERATURE_HEADER | 0x05, _temperatureSpread);
 }
 #endif
 
@@ -400,6 +1225,12 @@ String Sensors::getStatus()
     if (bitRead(_status,SENSORS_LIGHT_SETUP_BIT)) {
         status += stringLight();
     }
+#endif
+#ifdef Sensors_boundedI2C
+    if (i2c.getFaults() > 0) {
+        status += "\nI2C:";
+        status += i2c.getFaults();
+    }
 #endif
     return status;
 }
@@ -407,22 +1238,31 @@ String Sensors::getStatus()
 
 #ifdef Sensors_xbee
 
-void Sensors::putXBeeInt(ByteBuffer *buffer, uint8_t sensor, int value)
+template <class Buffer>
+uint8_t Sensors::putXBeeInt(Buffer *buffer, uint8_t sensor, int16_t value)
 {
-    if(buffer->getFreeSize() >= 5) {
-        buffer->put(XBEE_SENSOR_HEADER);
-        buffer->put(sensor);
-        buffer->putInt(value);
+    if (value == SENSORS_VALUE_INVALID) {
+        return SENSORS_RECORD_SKIPPED;
     }
+    if (buffer->getFreeSize() < XBEE_INT_RECORD_SIZE) {
+        return SENSORS_RECORD_FULL;
+    }
+    buffer->put(XBEE_SENSOR_HEADER);
+    buffer->put(sensor);
+    buffer->putInt(value);
+    return SENSORS_RECORD_WRITTEN;
 }
 
-void Sensors::putXBeeLong(ByteBuffer *buffer, uint8_t sensor, long value)
+template <class Buffer>
+uint8_t Sensors::putXBeeLong(Buffer *buffer, uint8_t sensor, long value)
 {
-    if (buffer->getFreeSize() >= 5) {
-        buffer->put(XBEE_SENSOR_HEADER);
-        buffer->put(sensor);
-        buffer->putLong(value);
+    if (buffer->getFreeSize() < XBEE_LONG_RECORD_SIZE) {
+        return SENSORS_RECORD_FULL;
     }
+    buffer->put(XBEE_SENSOR_HEADER);
+    buffer->put(sensor);
+    buffer->putLong(value);
+    return SENSORS_RECORD_WRITTEN;
 }
 
 #endif
@@ -436,47 +1276,262 @@ void Sensors::loopTime()
 #ifdef Sensors_temperatureRTC
 void Sensors::loopTemperatureRTC()
 {
-    int t = RTC.temperature();
-    float celsius = t / 4.0;
-    _temperatureRTC = celsius;
+    int t = RTC.temperature();  // 0.25 C steps
+    int16_t temperatureRTC = checkCenti((long)t * 25, SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+    if (temperatureRTC != SENSORS_VALUE_INVALID) {
+        _temperatureRTC = temperatureRTC;
+    }
 }
 #endif
 #endif
 
 #ifdef Sensors_enableDHT
+#ifdef Sensors_captureDHT
+// Temperature and humidity come from the same frame
+void Sensors::loopCaptureDHT()
+{
+    if (!dht.available()) {
+        return;
+    }
+    int16_t temperatureDHT = checkCenti(dht.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+    if (temperatureDHT != SENSORS_VALUE_INVALID) {
+        _temperatureDHT = temperatureDHT;
+    }
+    int16_t humidity = checkCenti(dht.getHumidity(), SENSORS_HUMIDITY_MIN, SENSORS_HUMIDITY_MAX);
+    if (humidity != SENSORS_VALUE_INVALID) {
+        _humidityDHT = humidity;
+    }
+#ifdef Sensors_dewPoint
+    loopDewPoint();
+#endif Sensors_dewPoint
+}
+#else
 void Sensors::loopTemperatureDHT()
 {
-    float temperatureDHT = dht.readTemperature();
-    if (!isnan(temperatureDHT) ) {
+    int16_t temperatureDHT = toCenti(dht.readTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+    if (temperatureDHT != SENSORS_VALUE_INVALID) {
         _temperatureDHT = temperatureDHT;
     }
 #ifdef Sensors_dewPoint
-    if(!isnan(_humidityDHT))
-        _dewpoint = dewPoint(_temperatureDHT,_humidityDHT);
+    loopDewPoint();
 #endif Sensors_dewPoint
 }
 
 void Sensors::loopHumidityDHT()
 {
-    float humidity = dht.readHumidity();
-    if( !isnan(humidity) ) {
+    int16_t humidity = toCenti(dht.readHumidity(), SENSORS_HUMIDITY_MIN, SENSORS_HUMIDITY_MAX);
+    if (humidity != SENSORS_VALUE_INVALID) {
         _humidityDHT = humidity;
     }
 #ifdef Sensors_dewPoint
-    if(!isnan(_temperatureDHT)) {
-        _dewpoint = dewPoint(_temperatureDHT,_humidityDHT);
-    }
+    loopDewPoint();
 #endif Sensors_dewPoint
-
 }
+#endif Sensors_captureDHT
 #endif Sensors_enableDHT
 
 #ifdef Sensors_dewPoint
 void Sensors::loopDewPoint()
 {
+    if (_temperatureDHT == SENSORS_VALUE_INVALID || _humidityDHT == SENSORS_VALUE_INVALID || _humidityDHT == 0) {
+        return;
+    }
+    double dewpoint = dewPoint((double)_temperatureDHT / SENSORS_FLOAT_TO_INT_MULTIPLY, (double)_humidityDHT / SENSORS_FLOAT_TO_INT_MULTIPLY);
+    _dewpoint = toCenti(dewpoint, SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
 }
 #endif Sensors_dewPoint
 
+#ifdef Sensors_alarms
+// Threshold with hysteresis and a limit on the change between samples,
+// evaluated every tick right after the samples of that tick
+void Sensors::loopAlarms()
+{
+    for (uint8_t i = 0; i < _alarmCount; i++) {
+        SensorsAlarm *alarm = &_alarms[i];
+        long value;
+        if (!getChannelValue(alarm->channel, &value)) {
+            continue;
+        }
+        if (alarm->rate > 0 && alarm->sampled && value != alarm->last) {
+            long change = value - alarm->last;
+            if (change > alarm->rate || change < -alarm->rate) {
+                alarm->pending |= SENSORS_ALARM_RATE;
+            }
+        }
+        alarm->last = value;
+        alarm->sampled = true;
+        bool above = alarm->flags & SENSORS_ALARM_ABOVE;
+        bool active = alarm->flags & SENSORS_ALARM_ACTIVE;
+        if (!active) {
+            if ((above && value > alarm->threshold) || (!above && value < alarm->threshold)) {
+                alarm->flags |= SENSORS_ALARM_ACTIVE;
+                alarm->pending |= SENSORS_ALARM_RAISED;
+            }
+        } else {
+            if ((above && value < alarm->threshold - alarm->hysteresis) || (!above && value > alarm->threshold + alarm->hysteresis)) {
+                alarm->flags &= ~SENSORS_ALARM_ACTIVE;
+                alarm->pending |= SENSORS_ALARM_CLEARED;
+            }
+        }
+    }
+}
+
+bool Sensors::getChannelValue(uint8_t channel, long *value)
+{
+    switch (channel) {
+#ifdef Sensors_temperatureRTC
+        case SENSORS_CHANNEL_TEMPERATURE_RTC:
+            *value = _temperatureRTC;
+            break;
+#endif
+#ifdef Sensors_enableDHT
+        case SENSORS_CHANNEL_TEMPERATURE_DHT:
+            *value = _temperatureDHT;
+            break;
+        case SENSORS_CHANNEL_HUMIDITY_DHT:
+            *value = _humidityDHT;
+            break;
+#endif
+#ifdef Sensors_enableTSL
+        case SENSORS_CHANNEL_LUX:
+            *value = (long)_lux * SENSORS_FLOAT_TO_INT_MULTIPLY;
+            return bitRead(_status,SENSORS_LIGHT_SETUP_BIT);
+        case SENSORS_CHANNEL_IR:
+            *value = (long)_ir * SENSORS_FLOAT_TO_INT_MULTIPLY;
+            return bitRead(_status,SENSORS_LIGHT_SETUP_BIT);
+        case SENSORS_CHANNEL_VISIBLE:
+            *value = (long)_visible * SENSORS_FLOAT_TO_INT_MULTIPLY;
+            return bitRead(_status,SENSORS_LIGHT_SETUP_BIT);
+        case SENSORS_CHANNEL_FULL:
+            *value = (long)_full * SENSORS_FLOAT_TO_INT_MULTIPLY;
+            return bitRead(_status,SENSORS_LIGHT_SETUP_BIT);
+#endif
+#ifdef Sensors_temperatureBMP
+        case SENSORS_CHANNEL_TEMPERATURE_BMP:
+            *value = _temperatureBMP;
+            break;
+#endif
+#ifdef Sensors_enableBMP
+        case SENSORS_CHANNEL_PRESSURE:
+            *value = _pressure;
+            return bitRead(_status,SENSORS_BMP_SETUP_BIT);
+#ifdef Sensors_seaLevelBMP
+        case SENSORS_CHANNEL_SEA_LEVEL:
+            *value = _seaLevel;
+            return bitRead(_status,SENSORS_BMP_SETUP_BIT);
+#endif
+#ifdef Sensors_altitudeBMP
+        case SENSORS_CHANNEL_ALTITUDE:
+            *value = _altitude;
+            return bitRead(_status,SENSORS_BMP_SETUP_BIT);
+#endif
+#endif
+#ifdef Sensors_dewPoint
+        case SENSORS_CHANNEL_DEWPOINT:
+            *value = _dewpoint;
+            break;
+#endif
+#ifdef Sensors_temperatureFusion
+        case SENSORS_CHANNEL_TEMPERATURE:
+            *value = _temperature;
+            break;
+#endif
+#ifdef Sensors_enableBME
+        case SENSORS_CHANNEL_TEMPERATURE_BME:
+            *value = _temperatureBME;
+            break;
+        case SENSORS_CHANNEL_HUMIDITY_BME:
+            *value = _humidityBME;
+            break;
+        case SENSORS_CHANNEL_PRESSURE_BME:
+            *value = _pressureBME;
+            return bitRead(_status,SENSORS_BME_SETUP_BIT);
+#endif
+        default:
+            return false;
+    }
+    return *value != SENSORS_VALUE_INVALID;
+}
+#endif Sensors_alarms
+
+#ifdef Sensors_temperatureFusion
+// Weighted mean of the calibrated sources, the spread is the largest
+// distance of a source from that mean
+void Sensors::loopTemperature()
+{
+    int16_t calibrated[SENSORS_TEMPERATURE_SOURCES];
+    long sum = 0;
+    long weights = 0;
+    for (uint8_t source = 0; source < SENSORS_TEMPERATURE_SOURCES; source++) {
+        int16_t value = getTemperatureSource(source);
+        calibrated[source] = SENSORS_VALUE_INVALID;
+        if (value == SENSORS_VALUE_INVALID || _temperatureWeight[source] == 0) {
+            continue;
+        }
+        long corrected = (((long)value * _temperatureGain[source]) >> 10) + _temperatureOffset[source];
+        calibrated[source] = checkCenti(corrected, SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+        if (calibrated[source] == SENSORS_VALUE_INVALID) {
+            continue;
+        }
+        sum += (long)calibrated[source] * _temperatureWeight[source];
+        weights += _temperatureWeight[source];
+    }
+    if (weights == 0) {
+        _temperature = SENSORS_VALUE_INVALID;
+        _temperatureSpread = SENSORS_VALUE_INVALID;
+        return;
+    }
+    _temperature = (sum + (sum < 0 ? -weights / 2 : weights / 2)) / weights;
+    int16_t spread = 0;
+    for (uint8_t source = 0; source < SENSORS_TEMPERATURE_SOURCES; source++) {
+        if (calibrated[source] != SENSORS_VALUE_INVALID) {
+            int16_t distance = abs(calibrated[source] - _temperature);
+            if (distance > spread) {
+                spread = distance;
+            }
+        }
+    }
+    _temperatureSpread = spread;
+}
+
+int16_t Sensors::getTemperatureSource(uint8_t source)
+{
+    switch (source) {
+#ifdef Sensors_temperatureRTC
+        case SENSORS_TEMPERATURE_RTC:
+            if (bitRead(_status,SENSORS_TEMPERATURE_RTC_SETUP_BIT)) {
+                return _temperatureRTC;
+            }
+            break;
+#endif
+#ifdef Sensors_enableDHT
+        case SENSORS_TEMPERATURE_DHT:
+            if (bitRead(_status,SENSORS_TEMPERATURE_DHT_SETUP_BIT)) {
+                return _temperatureDHT;
+            }
+            break;
+#endif
+#ifdef Sensors_temperatureBMP
+        case SENSORS_TEMPERATURE_BMP:
+            if (bitRead(_status,SENSORS_TEMPERATURE_BMP_SETUP_BIT)) {
+                return _temperatureBMP;
+            }
+            break;
+#endif
+#ifdef Sensors_enableBME
+        case SENSORS_TEMPERATURE_BME:
+            if (bitRead(_status,SENSORS_BME_SETUP_BIT)) {
+                return _temperatureBME;
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    return SENSORS_VALUE_INVALID;
+}
+#endif Sensors_temperatureFusion
+
 #ifdef Sensors_enableTSL
 void Sensors::loopLight()
 {
@@ -496,19 +1551,62 @@ void Sensors::loopLight()
 #endif Sensors_enableTSL
 
 #ifdef Sensors_enableBMP
-void Sensors::loopBMP()
+// True when a new pressure was stored
+bool Sensors::loopBMP()
 {
+#ifdef Sensors_integerBMP
+    if (!bmp.read()) {
+        return false;
+    }
+    _pressure = bmp.getPressure();
+#ifdef Sensors_seaLevelBMP
+    _seaLevel = SensorsBMP::seaLevel(_pressure, SENSORS_ALTITUDE);
+#endif
+#ifdef Sensors_altitudeBMP
+    _altitude = SensorsBMP::altitude(_pressure);
+#endif
+#ifdef Sensors_temperatureBMP
+    int16_t temperatureBMP = checkCenti(bmp.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+    if (temperatureBMP != SENSORS_VALUE_INVALID) {
+        _temperatureBMP = temperatureBMP;
+    }
+#endif Sensors_temperatureBMP
+#else
     //bmp.PrintCalibrationData();
     _pressure = bmp.getPressure();
 #ifdef Sensors_temperatureBMP
-    float temperatureBMP = bmp.getTemperature();
-    if( !isnan(temperatureBMP)) {
+    int16_t temperatureBMP = toCenti(bmp.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+    if (temperatureBMP != SENSORS_VALUE_INVALID) {
         _temperatureBMP = temperatureBMP;
     }
 #endif Sensors_temperatureBMP
+#endif Sensors_integerBMP
+    return true;
 }
 #endif Sensors_enableBMP
 
+#ifdef Sensors_enableBME
+// One burst gives all three, a failed read keeps the last values
+// True when a new temperature was stored
+bool Sensors::loopBME()
+{
+    if (!bme.read()) {
+        return false;
+    }
+    int16_t temperature = checkCenti(bme.getTemperature(), SENSORS_TEMPERATURE_MIN, SENSORS_TEMPERATURE_MAX);
+    if (temperature == SENSORS_VALUE_INVALID) {
+        return false;
+    }
+    _temperatureBME = temperature;
+    int16_t humidity = checkCenti(bme.getHumidity(), SENSORS_HUMIDITY_MIN, SENSORS_HUMIDITY_MAX);
+    if (humidity != SENSORS_VALUE_INVALID) {
+        _humidityBME = humidity;
+    }
+    _pressureBME = bme.getPressure();
+    return true;
+}
+#endif Sensors_enableBME
+
 #ifdef Sensors_enableRTC
 String  Sensors::stringTime()
 {
@@ -566,9 +1664,9 @@ String Sensors::stringDigits(int digits){
 String Sensors::stringTemperatureRTC()
 {
     String text = "";
-    if (!isnan(_temperatureRTC)) {
+    if (_temperatureRTC != SENSORS_VALUE_INVALID) {
         text += "Temp:";
-        text += _temperatureRTC;
+        text += stringCenti(_temperatureRTC);
         text += "C";
     }
     return text;
@@ -580,9 +1678,9 @@ String Sensors::stringTemperatureRTC()
 String Sensors::stringTemperatureDHT()
 {
     String text = "";
-    if (!isnan(_temperatureDHT)) {
+    if (_temperatureDHT != SENSORS_VALUE_INVALID) {
         text += "Temp:";
-        text += _temperatureDHT;
+        text += stringCenti(_temperatureDHT);
         text += "C";
     }
     return text;
@@ -591,9 +1689,9 @@ String Sensors::stringTemperatureDHT()
 String Sensors::stringHumidityDHT()
 {
     String text = "";
-    if (!isnan(_humidityDHT)) {
+    if (_humidityDHT != SENSORS_VALUE_INVALID) {
         text += "Humi:";
-        text += _humidityDHT;
+        text += stringCenti(_humidityDHT);
         text += "%";
     }
     return text;
@@ -601,12 +1699,12 @@ String Sensors::stringHumidityDHT()
 #endif Sensors_enableDHT
 
 #ifdef Sensors_dewPoint
-string Sensors::stringDewpoint()
+String Sensors::stringDewpoint()
 {
     String text = "";
-    if (!isnan(_dewpoint ) ) {
+    if (_dewpoint != SENSORS_VALUE_INVALID) {
         text += ", DewP:";
-        text += _dewpoint;
+        text += stringCenti(_dewpoint);
         text += "°";
     }
     return text;
@@ -634,9 +1732,9 @@ String Sensors::stringBMP()
 {
     String text = "";
 #ifdef Sensors_temperatureBMP
-    if (!isnan(_temperatureBMP)) {
+    if (_temperatureBMP != SENSORS_VALUE_INVALID) {
         text += "Temp:";
-        text += _temperatureBMP;
+        text += stringCenti(_temperatureBMP);
         text += "C (BMP)";
     }
 #endif Sensors_temperatureBMP
@@ -646,6 +1744,22 @@ String Sensors::stringBMP()
 }
 #endif Sensors_enableBMP
 
+String Sensors::stringCenti(int16_t value)
+{
+    String text = "";
+    if (value < 0) {
+        text += "-";
+        value = -value;
+    }
+    text += value / SENSORS_FLOAT_TO_INT_MULTIPLY;
+    text += ".";
+    if (value % SENSORS_FLOAT_TO_INT_MULTIPLY < 10) {
+        text += "0";
+    }
+    text += value % SENSORS_FLOAT_TO_INT_MULTIPLY;
+    return text;
+}
+
 #ifdef Sensors_print
 void Sensors::printStatus()
 {
@@ -736,3 +1850,117 @@ double Sensors::dewPoint(double celsius, double humidity)
 #endif Sensors_dewPointFast
 #endif Sensors_dewPoint
 
+// Driver floats are converted once, at read time
+int16_t Sensors::toCenti(float value, int16_t minimum, int16_t maximum)
+{
+    if (isnan(value)) {
+        return SENSORS_VALUE_INVALID;
+    }
+    value *= SENSORS_FLOAT_TO_INT_MULTIPLY;
+    if (value < minimum || value > maximum) {
+        return SENSORS_VALUE_INVALID;
+    }
+    return (int16_t)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+int16_t Sensors::checkCenti(long value, int16_t minimum, int16_t maximum)
+{
+    if (value < minimum || value > maximum) {
+        return SENSORS_VALUE_INVALID;
+    }
+    return (int16_t)value;
+}
+
+#ifdef Sensors_xbee
+// Record writers for a ByteBuffer and for an in-place XBee API frame
+template uint8_t Sensors::putXBeeData(ByteBuffer *buffer, uint32_t channels);
+template uint8_t Sensors::putXBeeRequest(const uint8_t *request, uint8_t length, ByteBuffer *buffer);
+#ifdef Sensors_alarms
+template uint8_t Sensors::putXBeeAlarms(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_enableRTC
+template uint8_t Sensors::putXBeeTime(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_temperatureRTC
+template uint8_t Sensors::putXBeeTemperatureRTC(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_enableDHT
+template uint8_t Sensors::putXBeeTemperatureDHT(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeeHumidityDHT(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_enableTSL
+template uint8_t Sensors::putXBeeLux(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeeIr(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeeVisible(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeeFull(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_temperatureBMP
+template uint8_t Sensors::putXBeeTemperatureBMP(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_enableBMP
+template uint8_t Sensors::putXBeePressure(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_seaLevelBMP
+template uint8_t Sensors::putXBeeSeaLevelPressure(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_altitudeBMP
+template uint8_t Sensors::putXBeeAltitude(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_dewPoint
+template uint8_t Sensors::putXBeeDewPoint(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_enableBME
+template uint8_t Sensors::putXBeeTemperatureBME(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeeHumidityBME(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeePressureBME(ByteBuffer *buffer);
+#endif
+#ifdef Sensors_temperatureFusion
+template uint8_t Sensors::putXBeeFusedTemperature(ByteBuffer *buffer);
+template uint8_t Sensors::putXBeeTemperatureSpread(ByteBuffer *buffer);
+#endif
+template uint8_t Sensors::putXBeeData(XBeeFrame *buffer, uint32_t channels);
+template uint8_t Sensors::putXBeeRequest(const uint8_t *request, uint8_t length, XBeeFrame *buffer);
+#ifdef Sensors_alarms
+template uint8_t Sensors::putXBeeAlarms(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_enableRTC
+template uint8_t Sensors::putXBeeTime(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_temperatureRTC
+template uint8_t Sensors::putXBeeTemperatureRTC(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_enableDHT
+template uint8_t Sensors::putXBeeTemperatureDHT(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeeHumidityDHT(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_enableTSL
+template uint8_t Sensors::putXBeeLux(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeeIr(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeeVisible(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeeFull(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_temperatureBMP
+template uint8_t Sensors::putXBeeTemperatureBMP(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_enableBMP
+template uint8_t Sensors::putXBeePressure(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_seaLevelBMP
+template uint8_t Sensors::putXBeeSeaLevelPressure(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_altitudeBMP
+template uint8_t Sensors::putXBeeAltitude(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_dewPoint
+template uint8_t Sensors::putXBeeDewPoint(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_enableBME
+template uint8_t Sensors::putXBeeTemperatureBME(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeeHumidityBME(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeePressureBME(XBeeFrame *buffer);
+#endif
+#ifdef Sensors_temperatureFusion
+template uint8_t Sensors::putXBeeFusedTemperature(XBeeFrame *buffer);
+template uint8_t Sensors::putXBeeTemperatureSpread(XBeeFrame *buffer);
+#endif
+#endif //Sensors_xbee
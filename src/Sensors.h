@@ -36,27 +36,58 @@
 #define Sensors_enableRTC
 #define Sensors_enableTSL
 #define Sensors_enableDHT
+//#define Sensors_captureDHT
 #define Sensors_enableBMP
+//#define Sensors_enableBME
+#define Sensors_integerBMP
+//#define Sensors_seaLevelBMP
+//#define Sensors_altitudeBMP
 #define Sensors_temperatureRTC
 #define Sensors_temperatureBMP
+//#define Sensors_temperatureFusion
 #define Sensors_reset
+//#define Sensors_alarms
+//#define Sensors_snapshot
+#define Sensors_boundedI2C
 
 #ifdef Sensors_enableTSL
 #include <TSL2561.h>
 #endif
 
 #ifdef Sensors_enableBMP
+#ifdef Sensors_integerBMP
+#include <SensorsBMP.h>
+#else
 #include <BMP180.h>
 #endif
+#endif
+
+#ifdef Sensors_captureDHT
+#include <SensorsDHT.h>
+#endif
+
+#ifdef Sensors_enableBME
+#include <SensorsBME.h>
+#endif
+
+#ifdef Sensors_boundedI2C
+#include <SensorsI2C.h>
+#endif
 
 #ifdef Sensors_xbee
 #include <ByteBuffer.h>
+#include <XBeeFrame.h>
+#include <XBeeQueue.h>
 #endif
 
 #ifdef Sensors_Relays
 #include <Relays.h>
 #endif
 
+#ifdef Sensors_snapshot
+#include <EEPROM.h>
+#endif
+
 #define SENSORS_STATUS_SETUP_BIT            0
 #define SENSORS_TIME_SETUP_BIT              1
 #ifdef Sensors_temperatureRTC
@@ -69,15 +100,32 @@
 #ifdef Sensors_temperatureBMP
 #define SENSORS_TEMPERATURE_BMP_SETUP_BIT   7
 #endif
+#define SENSORS_BME_SETUP_BIT               8
 
 #define SENSORS_SETUP_RUNS                  5
 
 #define SENSORS_FLOAT_TO_INT_MULTIPLY       100
 
+#define SENSORS_ALTITUDE                    0       // m, station height for Sensors_seaLevelBMP
+
+// Readings are kept in centi-units (0.01 C, 0.01 %RH) as int16_t
+#define SENSORS_VALUE_INVALID               ((int16_t)0x8000)
+#define SENSORS_TEMPERATURE_MIN             -4000
+#define SENSORS_TEMPERATURE_MAX             8500
+#define SENSORS_HUMIDITY_MIN                0
+#define SENSORS_HUMIDITY_MAX                10000
+
+#ifdef Sensors_captureDHT
+#define DHTPIN 2    // Must be an interrupt pin, INT0 on Uno
+#else
 #define DHTPIN 7
+#endif
 #define DHTTYPE DHT22   // DHT 22  (AM2302)
 
+#define XBEE_STALE_HEADER           0x04
+#define XBEE_ALARM_HEADER           0x08
 #define XBEE_TIME_HEADER            0x10
+#define XBEE_REQUEST_HEADER         0x20
 #define XBEE_SENSOR_HEADER          0x40
 #define XBEE_POWER_HEADER           0x80
 
@@ -89,11 +137,137 @@
 #define XBEE_VISIBLE_HEADER         0x0A << 3   // V
 #define XBEE_FULL_HEADER            0x0B << 3   // F
 #define XBEE_PRESSURE_HEADER        0x0C << 3   // P
+#define XBEE_ALTITUDE_HEADER        0x0D << 3   // A
+
+// Channel bits for putXBeeData() and XBEE_REQUEST_HEADER frames
+#define SENSORS_CHANNEL_TIME                0
+#define SENSORS_CHANNEL_TEMPERATURE_RTC     1
+#define SENSORS_CHANNEL_TEMPERATURE_DHT     2
+#define SENSORS_CHANNEL_HUMIDITY_DHT        3
+#define SENSORS_CHANNEL_LUX                 4
+#define SENSORS_CHANNEL_IR                  5
+#define SENSORS_CHANNEL_VISIBLE             6
+#define SENSORS_CHANNEL_FULL                7
+#define SENSORS_CHANNEL_TEMPERATURE_BMP     8
+#define SENSORS_CHANNEL_PRESSURE            9
+#define SENSORS_CHANNEL_SEA_LEVEL           10
+#define SENSORS_CHANNEL_ALTITUDE            11
+#define SENSORS_CHANNEL_DEWPOINT            12
+#define SENSORS_CHANNEL_TEMPERATURE         13
+#define SENSORS_CHANNEL_TEMPERATURE_SPREAD  14
+#define SENSORS_CHANNEL_TEMPERATURE_BME     15
+#define SENSORS_CHANNEL_HUMIDITY_BME        16
+#define SENSORS_CHANNEL_PRESSURE_BME        17
+#define SENSORS_CHANNELS                    18
+#define SENSORS_CHANNELS_ALL                0xFFFFFFFF
+#ifdef Sensors_temperatureFusion
+#define SENSORS_CHANNELS_DEFAULT            (SENSORS_CHANNELS_ALL & ~((1UL << SENSORS_CHANNEL_TEMPERATURE_RTC) | (1UL << SENSORS_CHANNEL_TEMPERATURE_DHT) | (1UL << SENSORS_CHANNEL_TEMPERATURE_BMP) | (1UL << SENSORS_CHANNEL_TEMPERATURE_BME)))
+#else
+#define SENSORS_CHANNELS_DEFAULT            SENSORS_CHANNELS_ALL
+#endif
+
+// Temperature fusion sources, gain is 1024 for 1.0
+#define SENSORS_TEMPERATURE_RTC             0
+#define SENSORS_TEMPERATURE_DHT             1
+#define SENSORS_TEMPERATURE_BMP             2
+#define SENSORS_TEMPERATURE_BME             3
+#define SENSORS_TEMPERATURE_SOURCES         4
+#define SENSORS_TEMPERATURE_GAIN            1024
+// Inverse variance of the datasheet accuracy: DS3231 3 C, BMP180 1 C, BME280 1 C, DHT22 0.5 C
+#define SENSORS_TEMPERATURE_WEIGHT_RTC      1
+#define SENSORS_TEMPERATURE_WEIGHT_DHT      36
+#define SENSORS_TEMPERATURE_WEIGHT_BMP      9
+#define SENSORS_TEMPERATURE_WEIGHT_BME      9
+
+// Result of writing one record
+#define SENSORS_RECORD_SKIPPED              0
+#define SENSORS_RECORD_WRITTEN              1
+#define SENSORS_RECORD_FULL                 2
+
+// Alarm rules, values in the unit of the channel record
+#define SENSORS_ALARMS                      4
+#define SENSORS_ALARM_ABOVE                 0x01
+#define SENSORS_ALARM_BELOW                 0x02
+#define SENSORS_ALARM_ACTIVE                0x80
+// Pending events are bits, the record carries them with SENSORS_ALARM_ACTIVE
+#define SENSORS_ALARM_NONE                  0
+#define SENSORS_ALARM_RAISED                0x01
+#define SENSORS_ALARM_CLEARED               0x02
+#define SENSORS_ALARM_RATE                  0x04
+#define XBEE_ALARM_RECORD_SIZE              3
+
+// Warm restart snapshot in EEPROM. The setup block only changes with the
+// sensors or the calibration, the readings are saved in the background
+// SENSORS_SNAPSHOT_TICKS loops apart (6 h) and before reset().
+#define SENSORS_SNAPSHOT_ADDRESS            0
+#define SENSORS_SNAPSHOT_MAGIC              0x53
+#define SENSORS_SNAPSHOT_TICKS              21600
+#define SENSORS_SNAPSHOT_IDLE               0xFF
+#define SENSORS_READINGS_ADDRESS            (SENSORS_SNAPSHOT_ADDRESS + sizeof(SensorsSnapshot) + 1)
+#define XBEE_STALE_RECORD_SIZE              1
+
+#define XBEE_TIME_RECORD_SIZE       (1 + sizeof(time_t))
+#define XBEE_INT_RECORD_SIZE        (2 + sizeof(int))
+#define XBEE_LONG_RECORD_SIZE       (2 + sizeof(long))
 
 #ifdef Sensors_reset
 extern void reset();
 #endif
 
+#ifdef Sensors_alarms
+struct SensorsAlarm
+{
+    uint8_t     channel;        // SENSORS_CHANNEL_*
+    uint8_t     flags;          // SENSORS_ALARM_ABOVE/BELOW/ACTIVE
+    uint8_t     pending;        // SENSORS_ALARM_RAISED | CLEARED | RATE
+    long        threshold;
+    long        hysteresis;
+    long        rate;           // Largest change between samples, 0 is off
+    long        last;
+    bool        sampled;
+};
+#endif
+
+#ifdef Sensors_snapshot
+struct SensorsSnapshot
+{
+    uint8_t     magic;          // SENSORS_SNAPSHOT_MAGIC
+    uint8_t     size;           // sizeof(SensorsSnapshot), changes with the flags
+    uint16_t    status;         // Sensors that passed setup
+#ifdef Sensors_temperatureFusion
+    int16_t     temperatureOffset[SENSORS_TEMPERATURE_SOURCES];
+    uint16_t    temperatureGain[SENSORS_TEMPERATURE_SOURCES];
+    uint8_t     temperatureWeight[SENSORS_TEMPERATURE_SOURCES];
+#endif
+#ifdef Sensors_integerBMP
+    uint8_t     calibrationBMP[SENSORS_BMP_CALIBRATION_SIZE];
+#endif
+#ifdef Sensors_enableBME
+    uint8_t     calibrationBME[SENSORS_BME_CALIBRATION_SIZE];
+#endif
+};
+
+struct SensorsReadings
+{
+    uint8_t     magic;          // SENSORS_SNAPSHOT_MAGIC
+    int16_t     temperatureRTC;
+    int16_t     temperatureDHT;
+    int16_t     humidityDHT;
+    int16_t     temperatureBMP;
+    int16_t     dewpoint;
+    int16_t     temperatureBME;
+    int16_t     humidityBME;
+    long        pressure;
+    long        seaLevel;
+    long        altitude;
+    long        pressureBME;
+    uint16_t    lux;
+    uint16_t    ir;
+    uint16_t    visible;
+    uint16_t    full;
+};
+#endif
+
 class Sensors
 {
 public:
@@ -101,11 +275,27 @@ public:
     void setup(uint8_t id = 0);
     
     bool isSetup();
+#ifdef Sensors_snapshot
+    bool saveSnapshot();
+    void clearSnapshot();
+    bool isStale();
+#endif
+#ifdef Sensors_boundedI2C
+    uint8_t getI2CFaults();
+#endif
     
     void loop();
 #ifdef Sensors_Relays
     void loop(Relays *relays);
 #endif
+#if defined(Sensors_xbee) && defined(Sensors_alarms)
+    void loop(XBeeQueue *queue);
+#endif
+#ifdef Sensors_alarms
+    bool addAlarm(uint8_t channel, uint8_t flags, long threshold, long hysteresis, long rate = 0);
+    void clearAlarms();
+    bool hasAlarms();
+#endif
     
 #ifdef Sensors_enableRTC
     time_t getTime();
@@ -113,9 +303,27 @@ public:
 #ifdef Sensors_enableDHT
     float getTemperature();
     float getHumidity();
+    int16_t getTemperatureCenti();
+    int16_t getHumidityCenti();
+#endif
+#ifdef Sensors_temperatureFusion
+    int16_t getFusedTemperature();
+    int16_t getTemperatureSpread();
+    void setTemperatureCalibration(uint8_t source, int16_t offset, uint16_t gain, uint8_t weight);
 #endif
 #ifdef Sensors_enableBMP
     long getPressure();
+#ifdef Sensors_seaLevelBMP
+    long getSeaLevelPressure();
+#endif
+#ifdef Sensors_altitudeBMP
+    long getAltitude();
+#endif
+#endif
+#ifdef Sensors_enableBME
+    int16_t getTemperatureBME();
+    int16_t getHumidityBME();
+    long getPressureBME();
 #endif
 #ifdef Sensors_enableTSL
     uint16_t getLux();
@@ -125,31 +333,53 @@ public:
 #endif
     
 #ifdef Sensors_xbee
-    uint8_t putXBeeData(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeData(Buffer *buffer, uint32_t channels = SENSORS_CHANNELS_DEFAULT);
+    template <class Buffer> uint8_t putXBeeRequest(const uint8_t *request, uint8_t length, Buffer *buffer);
+    bool queueXBeeData(XBeeQueue *queue, uint32_t channels = SENSORS_CHANNELS_DEFAULT);
+    bool isXBeeComplete();
+#ifdef Sensors_alarms
+    template <class Buffer> uint8_t putXBeeAlarms(Buffer *buffer);
+#endif
+    void setXBeePriority(const uint8_t *channels, uint8_t count);
 #ifdef Sensors_enableRTC
-    void putXBeeTime(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeTime(Buffer *buffer);
 #ifdef Sensors_temperatureRTC
-    void putXBeeTemperatureRTC(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeTemperatureRTC(Buffer *buffer);
 #endif
 #endif
 #ifdef Sensors_enableDHT
-    void putXBeeTemperatureDHT(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeTemperatureDHT(Buffer *buffer);
 #endif
 #ifdef Sensors_temperatureBMP
-    void putXBeeTemperatureBMP(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeTemperatureBMP(Buffer *buffer);
 #endif
-    void putXBeeHumidityDHT(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeHumidityDHT(Buffer *buffer);
 #ifdef Sensors_enableTSL
-    void putXBeeLux(ByteBuffer *buffer);
-    void putXBeeIr(ByteBuffer *buffer);
-    void putXBeeVisible(ByteBuffer *buffer);
-    void putXBeeFull(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeLux(Buffer *buffer);
+    template <class Buffer> uint8_t putXBeeIr(Buffer *buffer);
+    template <class Buffer> uint8_t putXBeeVisible(Buffer *buffer);
+    template <class Buffer> uint8_t putXBeeFull(Buffer *buffer);
 #endif
 #ifdef Sensors_enableBMP
-    void putXBeePressure(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeePressure(Buffer *buffer);
+#ifdef Sensors_seaLevelBMP
+    template <class Buffer> uint8_t putXBeeSeaLevelPressure(Buffer *buffer);
+#endif
+#ifdef Sensors_altitudeBMP
+    template <class Buffer> uint8_t putXBeeAltitude(Buffer *buffer);
+#endif
 #endif
 #ifdef Sensors_dewPoint
-    void putXBeeDewPoint(ByteBuffer *buffer);
+    template <class Buffer> uint8_t putXBeeDewPoint(Buffer *buffer);
+#endif
+#ifdef Sensors_enableBME
+    template <class Buffer> uint8_t putXBeeTemperatureBME(Buffer *buffer);
+    template <class Buffer> uint8_t putXBeeHumidityBME(Buffer *buffer);
+    template <class Buffer> uint8_t putXBeePressureBME(Buffer *buffer);
+#endif
+#ifdef Sensors_temperatureFusion
+    template <class Buffer> uint8_t putXBeeFusedTemperature(Buffer *buffer);
+    template <class Buffer> uint8_t putXBeeTemperatureSpread(Buffer *buffer);
 #endif
 #endif //Sensors_xbee
 #ifdef Sensors_status
@@ -166,21 +396,56 @@ private:
 #endif
 
     unsigned long   _last_run       =   0;
+    unsigned long   _interval       =   SENSORS_LOOP_CHECK;
+#ifdef Sensors_xbee
+    uint8_t         _priority[SENSORS_CHANNELS] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 };
+    uint8_t         _cursor         =   0;
+    uint32_t        _cursorChannels =   0;              // Mask of the snapshot at _cursor
+    bool            _partial        =   false;          // The snapshot stopped on a full buffer
+#endif
+#ifdef Sensors_snapshot
+    bool            _stale          =   false;
+    uint16_t        _snapshotTicks  =   0;
+    uint8_t         _snapshotByte   =   SENSORS_SNAPSHOT_IDLE;  // Next byte of _readings to write
+    SensorsReadings _readings;
+#endif
+#ifdef Sensors_alarms
+    SensorsAlarm    _alarms[SENSORS_ALARMS];
+    uint8_t         _alarmCount     =   0;
+#endif
 #ifdef Sensors_enableRTC
 #ifdef Sensors_temperatureRTC
-    float           _temperatureRTC =   NAN;
+    int16_t         _temperatureRTC =   SENSORS_VALUE_INVALID;  // 0.01 C
 #endif
 #endif
-    float           _temperatureDHT =   NAN;
+    int16_t         _temperatureDHT =   SENSORS_VALUE_INVALID;  // 0.01 C
 #ifdef Sensors_temperatureBMP
-    float           _temperatureBMP =   NAN;
+    int16_t         _temperatureBMP =   SENSORS_VALUE_INVALID;  // 0.01 C
 #endif
-    float           _humidityDHT    =   NAN;
+    int16_t         _humidityDHT    =   SENSORS_VALUE_INVALID;  // 0.01 %RH
 #ifdef Sensors_dewPoint
-    int             _dewpoint       =   0;
+    int16_t         _dewpoint       =   SENSORS_VALUE_INVALID;  // 0.01 C
+#endif
+#ifdef Sensors_temperatureFusion
+    int16_t         _temperature    =   SENSORS_VALUE_INVALID;  // 0.01 C
+    int16_t         _temperatureSpread = SENSORS_VALUE_INVALID; // 0.01 C
+    int16_t         _temperatureOffset[SENSORS_TEMPERATURE_SOURCES] = { 0, 0, 0, 0 };
+    uint16_t        _temperatureGain[SENSORS_TEMPERATURE_SOURCES] = { SENSORS_TEMPERATURE_GAIN, SENSORS_TEMPERATURE_GAIN, SENSORS_TEMPERATURE_GAIN, SENSORS_TEMPERATURE_GAIN };
+    uint8_t         _temperatureWeight[SENSORS_TEMPERATURE_SOURCES] = { SENSORS_TEMPERATURE_WEIGHT_RTC, SENSORS_TEMPERATURE_WEIGHT_DHT, SENSORS_TEMPERATURE_WEIGHT_BMP, SENSORS_TEMPERATURE_WEIGHT_BME };
 #endif
 #ifdef Sensors_enableBMP
-    long            _pressure       =   0;
+    long            _pressure       =   0;              // Pa
+#ifdef Sensors_seaLevelBMP
+    long            _seaLevel       =   0;              // Pa
+#endif
+#ifdef Sensors_altitudeBMP
+    long            _altitude       =   0;              // cm
+#endif
+#endif
+#ifdef Sensors_enableBME
+    int16_t         _temperatureBME =   SENSORS_VALUE_INVALID;  // 0.01 C
+    int16_t         _humidityBME    =   SENSORS_VALUE_INVALID;  // 0.01 %RH
+    long            _pressureBME    =   0;                      // Pa
 #endif
 #ifdef Sensors_enableTSL
     uint16_t        _lux            =   0;
@@ -199,23 +464,47 @@ private:
 #endif
 #endif
 #ifdef Sensors_enableDHT
+#ifdef Sensors_captureDHT
+    void        loopCaptureDHT();
+#else
     void        loopTemperatureDHT();
     void        loopHumidityDHT();
 #endif
+#endif
 #ifdef Sensors_enableTSL
     void        loopLight();
 #endif
 #ifdef Sensors_enableBMP
-    void        loopBMP();
+    bool        loopBMP();
+#endif
+#ifdef Sensors_enableBME
+    bool        loopBME();
 #endif
 #ifdef Sensors_dewPoint
     void        loopDewPoint();
 #endif
+#ifdef Sensors_snapshot
+    bool        restoreSnapshot();
+    void        saveSetup();
+    void        dropReadings();
+    void        loopSnapshot();
+    void        getReadings(SensorsReadings *readings);
+    void        setReadings(const SensorsReadings *readings);
+#endif
+#ifdef Sensors_alarms
+    void        loopAlarms();
+    bool        getChannelValue(uint8_t channel, long *value);
+#endif
+#ifdef Sensors_temperatureFusion
+    void        loopTemperature();
+    int16_t     getTemperatureSource(uint8_t source);
+#endif
     
 #ifdef Sensors_xbee
-    void     putXBeeInt(ByteBuffer *buffer, uint8_t sensor, int value);
+    template <class Buffer> uint8_t putXBeeChannel(Buffer *buffer, uint8_t channel);
+    template <class Buffer> uint8_t putXBeeInt(Buffer *buffer, uint8_t sensor, int16_t value);
     //uint8_t     putXBeeFloat(ByteBuffer *buffer, uint8_t sensor, float value);
-    void     putXBeeLong(ByteBuffer *buffer, uint8_t sensor, long value);
+    template <class Buffer> uint8_t putXBeeLong(Buffer *buffer, uint8_t sensor, long value);
 #endif
     
 #ifdef Sensors_enableRTC
@@ -241,6 +530,10 @@ private:
 #ifdef Sensors_print
     void        printStatus();
 #endif
+    String      stringCenti(int16_t value);
+
+    int16_t     toCenti(float value, int16_t minimum, int16_t maximum);
+    int16_t     checkCenti(long value, int16_t minimum, int16_t maximum);
 
 #ifdef Sensors_dewPoint
     double      dewPoint(double celsius, double humidity);
@@ -0,0 +1,223 @@
+//
+//  SensorsBME
+//  Library C++ code
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <SensorsBME.h>
+
+bool SensorsBME::begin(uint8_t mode, uint8_t address)
+{
+    uint8_t tp[24];
+    uint8_t h[7];
+    uint8_t h1;
+    _mode = mode;
+    _address = address;
+    if (!probe()) {
+        return false;
+    }
+    if (!readRegisters(SENSORS_BME_REG_CALIBRATION_TP, tp, sizeof(tp))
+        || !readRegisters(SENSORS_BME_REG_CALIBRATION_H1, &h1, 1)
+        || !readRegisters(SENSORS_BME_REG_CALIBRATION_H2, h, sizeof(h))) {
+        return false;
+    }
+    setCalibration(tp, h1, h);
+    return configure() && settle();
+}
+
+// Warm start with calibration from getCalibration(), the sensor may have
+// lost power so the control registers are written again
+bool SensorsBME::begin(const uint8_t *calibration, uint8_t mode, uint8_t address)
+{
+    _mode = mode;
+    _address = address;
+    if (!probe()) {
+        return false;
+    }
+    setCalibration(calibration, calibration[24], calibration + 25);
+    return configure() && settle();
+}
+
+bool SensorsBME::probe()
+{
+    uint8_t id;
+    return readRegisters(SENSORS_BME_REG_CHIP_ID, &id, 1) && id == SENSORS_BME_CHIP_ID;
+}
+
+bool SensorsBME::configure()
+{
+    // ctrl_hum only takes effect after a write to ctrl_meas
+    if (!writeRegister(SENSORS_BME_REG_CTRL_HUM, SENSORS_BME_OVERSAMPLING)
+        || !writeRegister(SENSORS_BME_REG_CONFIG, SENSORS_BME_STANDBY << 5)) {
+        return false;
+    }
+    return writeRegister(SENSORS_BME_REG_CTRL_MEAS, (SENSORS_BME_OVERSAMPLING << 5) | (SENSORS_BME_OVERSAMPLING << 2) | _mode);
+}
+
+bool SensorsBME::read()
+{
+    uint8_t data[8];
+    if (_mode == SENSORS_BME_MODE_FORCED) {
+        if (!writeRegister(SENSORS_BME_REG_CTRL_MEAS, (SENSORS_BME_OVERSAMPLING << 5) | (SENSORS_BME_OVERSAMPLING << 2) | _mode)) {
+            return false;
+        }
+        unsigned long start = millis();
+        do {
+            if (millis() - start > SENSORS_BME_TIMEOUT || !readRegisters(SENSORS_BME_REG_STATUS, data, 1)) {
+                return false;
+            }
+        } while (data[0] & SENSORS_BME_MEASURING);
+    }
+    if (!readRegisters(SENSORS_BME_REG_DATA, data, sizeof(data))) {
+        return false;
+    }
+    int32_t adcP = ((uint32_t)data[0] << 12) | ((uint32_t)data[1] << 4) | (data[2] >> 4);
+    int32_t adcT = ((uint32_t)data[3] << 12) | ((uint32_t)data[4] << 4) | (data[5] >> 4);
+    int32_t adcH = ((uint32_t)data[6] << 8) | data[7];
+    // Skipped values compensate to plausible readings, never use them
+    if (adcT == SENSORS_BME_SKIPPED_TP || adcP == SENSORS_BME_SKIPPED_TP || adcH == SENSORS_BME_SKIPPED_H) {
+        return false;
+    }
+    compensate(adcT, adcP, adcH);
+    return true;
+}
+
+int16_t SensorsBME::getTemperature()
+{
+    return _temperature;
+}
+
+int16_t SensorsBME::getHumidity()
+{
+    return _humidity;
+}
+
+long SensorsBME::getPressure()
+{
+    return _pressure;
+}
+
+// 24 bytes from 0x88, 1 byte from 0xA1 and 7 bytes from 0xE1, little endian
+void SensorsBME::setCalibration(const uint8_t *tp, uint8_t h1, const uint8_t *h)
+{
+    _t1 = (tp[1] << 8) | tp[0];
+    _t2 = (tp[3] << 8) | tp[2];
+    _t3 = (tp[5] << 8) | tp[4];
+    _p1 = (tp[7] << 8) | tp[6];
+    _p2 = (tp[9] << 8) | tp[8];
+    _p3 = (tp[11] << 8) | tp[10];
+    _p4 = (tp[13] << 8) | tp[12];
+    _p5 = (tp[15] << 8) | tp[14];
+    _p6 = (tp[17] << 8) | tp[16];
+    _p7 = (tp[19] << 8) | tp[18];
+    _p8 = (tp[21] << 8) | tp[20];
+    _p9 = (tp[23] << 8) | tp[22];
+    _h1 = h1;
+    _h2 = (h[1] << 8) | h[0];
+    _h3 = h[2];
+    _h4 = ((int16_t)(int8_t)h[3] << 4) | (h[4] & 0x0F);
+    _h5 = ((int16_t)(int8_t)h[5] << 4) | (h[4] >> 4);
+    _h6 = (int8_t)h[6];
+}
+
+// Inverse of setCalibration(), tp, h1 and h in one block
+void SensorsBME::getCalibration(uint8_t *data)
+{
+    uint16_t words[12] = { _t1, (uint16_t)_t2, (uint16_t)_t3, _p1, (uint16_t)_p2, (uint16_t)_p3, (uint16_t)_p4, (uint16_t)_p5, (uint16_t)_p6, (uint16_t)_p7, (uint16_t)_p8, (uint16_t)_p9 };
+    for (uint8_t i = 0; i < 12; i++) {
+        data[2 * i] = words[i] & 0xFF;
+        data[2 * i + 1] = words[i] >> 8;
+    }
+    data[24] = _h1;
+    data[25] = _h2 & 0xFF;
+    data[26] = (uint16_t)_h2 >> 8;
+    data[27] = _h3;
+    data[28] = _h4 >> 4;
+    data[29] = (_h4 & 0x0F) | ((_h5 & 0x0F) << 4);
+    data[30] = _h5 >> 4;
+    data[31] = _h6;
+}
+
+// BME280 datasheet, section 4.2.3, 32 bit integer versions
+void SensorsBME::compensate(int32_t adcT, int32_t adcP, int32_t adcH)
+{
+    int32_t var1 = ((((adcT >> 3) - ((int32_t)_t1 << 1))) * ((int32_t)_t2)) >> 11;
+    int32_t var2 = (((((adcT >> 4) - ((int32_t)_t1)) * ((adcT >> 4) - ((int32_t)_t1))) >> 12) * ((int32_t)_t3)) >> 14;
+    int32_t fine = var1 + var2;
+    _temperature = (fine * 5 + 128) >> 8;
+
+    var1 = (fine >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)_p6);
+    var2 = var2 + ((var1 * ((int32_t)_p5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t)_p4) << 16);
+    var1 = (((_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)_p2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)_p1)) >> 15);
+    if (var1 != 0) {
+        uint32_t p = (((uint32_t)(((int32_t)1048576) - adcP) - (var2 >> 12))) * 3125;
+        if (p < 0x80000000UL) {
+            p = (p << 1) / ((uint32_t)var1);
+        } else {
+            p = (p / (uint32_t)var1) * 2;
+        }
+        var1 = (((int32_t)_p9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+        var2 = (((int32_t)(p >> 2)) * ((int32_t)_p8)) >> 13;
+        _pressure = (uint32_t)((int32_t)p + ((var1 + var2 + _p7) >> 4));
+    }
+
+    int32_t h = fine - ((int32_t)76800);
+    h = (((((adcH << 14) - (((int32_t)_h4) << 20) - (((int32_t)_h5) * h)) + ((int32_t)16384)) >> 15)
+        * (((((((h * ((int32_t)_h6)) >> 10) * (((h * ((int32_t)_h3)) >> 11) + ((int32_t)32768))) >> 10)
+        + ((int32_t)2097152)) * ((int32_t)_h2) + 8192) >> 14));
+    h = (h - (((((h >> 15) * (h >> 15)) >> 7) * ((int32_t)_h1)) >> 4));
+    h = (h < 0 ? 0 : h);
+    h = (h > 419430400 ? 419430400 : h);
+    // %RH in Q22.10 to 0.01 %RH
+    _humidity = ((uint32_t)(h >> 12) * 100) >> 10;
+}
+
+// Right after configure() the data registers still hold the reset values
+bool SensorsBME::settle()
+{
+    unsigned long start = millis();
+    while (!read()) {
+        if (millis() - start > SENSORS_BME_TIMEOUT) {
+            return false;
+        }
+        delay(1);
+    }
+    return true;
+}
+
+bool SensorsBME::readRegisters(uint8_t reg, uint8_t *data, uint8_t length)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    if (Wire.endTransmission() != 0) {
+        return false;
+    }
+    if (Wire.requestFrom(_address, length) != length) {
+        return false;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = Wire.read();
+    }
+    return true;
+}
+
+bool SensorsBME::writeRegister(uint8_t reg, uint8_t value)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
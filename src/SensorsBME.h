@@ -0,0 +1,86 @@
+//
+//  SensorsBME
+//  Header
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  BME280 reader. Temperature, humidity and pressure come from one
+//  8 byte burst read and the datasheet 32 bit integer compensation.
+//  In normal mode the sensor measures on its own and a read is only
+//  the burst, in forced mode read() starts one conversion first.
+//  begin() returns once the first conversion has produced real data.
+//
+
+#ifndef SensorsBME_h
+#define SensorsBME_h
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <Wire.h>
+
+#define SENSORS_BME_ADDRESS             0x76
+#define SENSORS_BME_CHIP_ID             0x60
+#define SENSORS_BME_REG_CALIBRATION_TP  0x88
+#define SENSORS_BME_REG_CALIBRATION_H1  0xA1
+#define SENSORS_BME_REG_CALIBRATION_H2  0xE1
+#define SENSORS_BME_REG_CHIP_ID         0xD0
+#define SENSORS_BME_REG_CTRL_HUM        0xF2
+#define SENSORS_BME_REG_STATUS          0xF3
+#define SENSORS_BME_REG_CTRL_MEAS       0xF4
+#define SENSORS_BME_REG_CONFIG          0xF5
+#define SENSORS_BME_REG_DATA            0xF7
+#define SENSORS_BME_CALIBRATION_SIZE    32      // 24 T/P, H1 and 7 H bytes
+
+#define SENSORS_BME_MODE_FORCED         0x01
+#define SENSORS_BME_MODE_NORMAL         0x03
+#define SENSORS_BME_OVERSAMPLING        0x01    // x1 for T, P and H
+#define SENSORS_BME_STANDBY             0x05    // 1000 ms in normal mode
+#define SENSORS_BME_MEASURING           0x08
+#define SENSORS_BME_TIMEOUT             15      // ms, forced conversion
+#define SENSORS_BME_SKIPPED_TP          0x80000 // Reset value, no conversion yet
+#define SENSORS_BME_SKIPPED_H           0x8000
+
+class SensorsBME
+{
+public:
+    bool begin(uint8_t mode = SENSORS_BME_MODE_NORMAL, uint8_t address = SENSORS_BME_ADDRESS);
+    bool begin(const uint8_t *calibration, uint8_t mode = SENSORS_BME_MODE_NORMAL, uint8_t address = SENSORS_BME_ADDRESS);
+    bool read();
+
+    int16_t getTemperature();   // 0.01 C
+    int16_t getHumidity();      // 0.01 %RH
+    long getPressure();         // Pa
+
+    void setCalibration(const uint8_t *tp, uint8_t h1, const uint8_t *h);
+    void getCalibration(uint8_t *data);
+    void compensate(int32_t adcT, int32_t adcP, int32_t adcH);
+
+private:
+    uint8_t     _address        =   SENSORS_BME_ADDRESS;
+    uint8_t     _mode           =   SENSORS_BME_MODE_NORMAL;
+    uint16_t    _t1;
+    int16_t     _t2, _t3;
+    uint16_t    _p1;
+    int16_t     _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9;
+    uint8_t     _h1, _h3;
+    int16_t     _h2, _h4, _h5;
+    int8_t      _h6;
+    int16_t     _temperature    =   0;
+    int16_t     _humidity       =   0;
+    long        _pressure       =   0;
+
+    bool        probe();
+    bool        configure();
+    bool        settle();
+    bool        readRegisters(uint8_t reg, uint8_t *data, uint8_t length);
+    bool        writeRegister(uint8_t reg, uint8_t value);
+};
+
+#endif
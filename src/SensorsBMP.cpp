@@ -0,0 +1,211 @@
+//
+//  SensorsBMP
+//  Library C++ code
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <SensorsBMP.h>
+
+// Standard atmosphere pressure / 2 in Pa, -500 m to 4500 m in 250 m steps
+static const uint16_t sensorsBMPTable[SENSORS_BMP_TABLE_SIZE] = {
+    53738, 52182, 50662, 49179, 47731, 46317, 44938, 43592, 42279, 40998, 39749,
+    38531, 37343, 36185, 35056, 33956, 32884, 31840, 30822, 29832, 28867
+};
+
+// Conversion time in ms for oversampling 0..3
+static const uint8_t sensorsBMPDelay[4] = { 5, 8, 14, 26 };
+
+bool SensorsBMP::begin(uint8_t oversampling)
+{
+    uint8_t data[SENSORS_BMP_CALIBRATION_SIZE];
+    _oss = oversampling > 3 ? 3 : oversampling;
+    if (!probe()) {
+        return false;
+    }
+    if (!readRegisters(SENSORS_BMP_REG_CALIBRATION, data, sizeof(data))) {
+        return false;
+    }
+    setCalibration(data);
+    return true;
+}
+
+// Warm start with calibration from getCalibration(), only the chip id is read
+bool SensorsBMP::begin(const uint8_t *calibration, uint8_t oversampling)
+{
+    _oss = oversampling > 3 ? 3 : oversampling;
+    if (!probe()) {
+        return false;
+    }
+    setCalibration(calibration);
+    return true;
+}
+
+bool SensorsBMP::read()
+{
+    uint8_t data[3];
+    if (!writeRegister(SENSORS_BMP_REG_CONTROL, SENSORS_BMP_CMD_TEMPERATURE)) {
+        return false;
+    }
+    delay(sensorsBMPDelay[0]);
+    if (!readRegisters(SENSORS_BMP_REG_DATA, data, 2)) {
+        return false;
+    }
+    long ut = ((long)data[0] << 8) | data[1];
+    if (!writeRegister(SENSORS_BMP_REG_CONTROL, SENSORS_BMP_CMD_PRESSURE + (_oss << 6))) {
+        return false;
+    }
+    delay(sensorsBMPDelay[_oss]);
+    if (!readRegisters(SENSORS_BMP_REG_DATA, data, 3)) {
+        return false;
+    }
+    long up = (((long)data[0] << 16) | ((long)data[1] << 8) | data[2]) >> (8 - _oss);
+    compensate(ut, up);
+    return true;
+}
+
+int16_t SensorsBMP::getTemperature()
+{
+    return _temperature;
+}
+
+long SensorsBMP::getPressure()
+{
+    return _pressure;
+}
+
+// 22 bytes from 0xAA, big endian
+void SensorsBMP::setCalibration(const uint8_t *data)
+{
+    _ac1 = (data[0] << 8) | data[1];
+    _ac2 = (data[2] << 8) | data[3];
+    _ac3 = (data[4] << 8) | data[5];
+    _ac4 = (data[6] << 8) | data[7];
+    _ac5 = (data[8] << 8) | data[9];
+    _ac6 = (data[10] << 8) | data[11];
+    _b1 = (data[12] << 8) | data[13];
+    _b2 = (data[14] << 8) | data[15];
+    _mc = (data[18] << 8) | data[19];
+    _md = (data[20] << 8) | data[21];
+}
+
+// Same layout as the calibration registers, MB is not used
+void SensorsBMP::getCalibration(uint8_t *data)
+{
+    uint16_t words[SENSORS_BMP_CALIBRATION_SIZE / 2] = { (uint16_t)_ac1, (uint16_t)_ac2, (uint16_t)_ac3, _ac4, _ac5, _ac6, (uint16_t)_b1, (uint16_t)_b2, 0, (uint16_t)_mc, (uint16_t)_md };
+    for (uint8_t i = 0; i < SENSORS_BMP_CALIBRATION_SIZE / 2; i++) {
+        data[2 * i] = words[i] >> 8;
+        data[2 * i + 1] = words[i] & 0xFF;
+    }
+}
+
+// BMP180 datasheet, section 3.5
+void SensorsBMP::compensate(long ut, long up)
+{
+    long x1 = ((ut - (long)_ac6) * (long)_ac5) >> 15;
+    long x2 = ((long)_mc << 11) / (x1 + _md);
+    long b5 = x1 + x2;
+    _temperature = ((b5 + 8) >> 4) * 10;
+
+    long b6 = b5 - 4000;
+    x1 = ((long)_b2 * ((b6 * b6) >> 12)) >> 11;
+    x2 = ((long)_ac2 * b6) >> 11;
+    long x3 = x1 + x2;
+    long b3 = ((((long)_ac1 * 4 + x3) << _oss) + 2) >> 2;
+    x1 = ((long)_ac3 * b6) >> 13;
+    x2 = ((long)_b1 * ((b6 * b6) >> 12)) >> 16;
+    x3 = ((x1 + x2) + 2) >> 2;
+    unsigned long b4 = ((unsigned long)_ac4 * (unsigned long)(x3 + 32768)) >> 15;
+    unsigned long b7 = ((unsigned long)up - b3) * (50000UL >> _oss);
+    long p;
+    if (b7 < 0x80000000UL) {
+        p = (b7 << 1) / b4;
+    } else {
+        p = (b7 / b4) << 1;
+    }
+    x1 = (p >> 8) * (p >> 8);
+    x1 = (x1 * 3038) >> 16;
+    x2 = (-7357 * p) >> 16;
+    _pressure = p + ((x1 + x2 + 3791) >> 4);
+}
+
+// Pressure reduced to sea level for a station at altitude (m)
+long SensorsBMP::seaLevel(long pressure, int altitude)
+{
+    long reference = standardPressure(altitude);
+    // Quartered so the product stays in 32 bits up to the table end
+    return pressure + ((pressure >> 2) * (SENSORS_BMP_SEA_LEVEL - reference)) / (reference >> 2);
+}
+
+// Altitude in cm for pressure against a sea-level reference
+long SensorsBMP::altitude(long pressure, long seaLevel)
+{
+    if (seaLevel <= 0) {
+        return 0;
+    }
+    long p = pressure + (pressure * (SENSORS_BMP_SEA_LEVEL - seaLevel)) / seaLevel;
+    uint8_t i = 1;
+    while (i < SENSORS_BMP_TABLE_SIZE - 1 && p < 2L * sensorsBMPTable[i]) {
+        i++;
+    }
+    long high = 2L * sensorsBMPTable[i - 1];
+    long low = 2L * sensorsBMPTable[i];
+    long base = SENSORS_BMP_TABLE_START + (long)(i - 1) * SENSORS_BMP_TABLE_STEP;
+    return base * 100 + ((high - p) * SENSORS_BMP_TABLE_STEP * 100) / (high - low);
+}
+
+long SensorsBMP::standardPressure(int altitude)
+{
+    long offset = (long)altitude - SENSORS_BMP_TABLE_START;
+    if (offset < 0) {
+        offset = 0;
+    }
+    uint8_t i = offset / SENSORS_BMP_TABLE_STEP;
+    if (i > SENSORS_BMP_TABLE_SIZE - 2) {
+        i = SENSORS_BMP_TABLE_SIZE - 2;
+    }
+    long high = 2L * sensorsBMPTable[i];
+    long low = 2L * sensorsBMPTable[i + 1];
+    long rest = offset - (long)i * SENSORS_BMP_TABLE_STEP;
+    return high - ((high - low) * rest) / SENSORS_BMP_TABLE_STEP;
+}
+
+bool SensorsBMP::probe()
+{
+    uint8_t id;
+    Wire.begin();
+    return readRegisters(SENSORS_BMP_REG_CHIP_ID, &id, 1) && id == SENSORS_BMP_CHIP_ID;
+}
+
+bool SensorsBMP::readRegisters(uint8_t reg, uint8_t *data, uint8_t length)
+{
+    Wire.beginTransmission(SENSORS_BMP_ADDRESS);
+    Wire.write(reg);
+    if (Wire.endTransmission() != 0) {
+        return false;
+    }
+    if (Wire.requestFrom((uint8_t)SENSORS_BMP_ADDRESS, length) != length) {
+        return false;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = Wire.read();
+    }
+    return true;
+}
+
+bool SensorsBMP::writeRegister(uint8_t reg, uint8_t value)
+{
+    Wire.beginTransmission(SENSORS_BMP_ADDRESS);
+    Wire.write(reg);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
@@ -0,0 +1,75 @@
+//
+//  SensorsBMP
+//  Header
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  BMP180 reader using the datasheet integer compensation. Calibration
+//  is read once in begin(), temperature and pressure come from one
+//  UT/UP pair. Sea-level pressure and altitude use a barometric table.
+//
+
+#ifndef SensorsBMP_h
+#define SensorsBMP_h
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <Wire.h>
+
+#define SENSORS_BMP_ADDRESS             0x77
+#define SENSORS_BMP_CHIP_ID             0x55
+#define SENSORS_BMP_REG_CALIBRATION     0xAA
+#define SENSORS_BMP_REG_CHIP_ID         0xD0
+#define SENSORS_BMP_REG_CONTROL         0xF4
+#define SENSORS_BMP_REG_DATA            0xF6
+#define SENSORS_BMP_CMD_TEMPERATURE     0x2E
+#define SENSORS_BMP_CMD_PRESSURE        0x34
+#define SENSORS_BMP_CALIBRATION_SIZE    22
+
+#define SENSORS_BMP_OSS                 2       // High resolution
+#define SENSORS_BMP_SEA_LEVEL           101325  // Pa, standard atmosphere
+
+#define SENSORS_BMP_TABLE_START         -500    // m
+#define SENSORS_BMP_TABLE_STEP          250     // m
+#define SENSORS_BMP_TABLE_SIZE          21
+
+class SensorsBMP
+{
+public:
+    bool begin(uint8_t oversampling = SENSORS_BMP_OSS);
+    bool begin(const uint8_t *calibration, uint8_t oversampling = SENSORS_BMP_OSS);
+    bool read();
+
+    int16_t getTemperature();   // 0.01 C
+    long getPressure();         // Pa
+
+    void setCalibration(const uint8_t *data);
+    void getCalibration(uint8_t *data);
+    void compensate(long ut, long up);
+
+    static long seaLevel(long pressure, int altitude);
+    static long altitude(long pressure, long seaLevel = SENSORS_BMP_SEA_LEVEL);
+
+private:
+    uint8_t     _oss            =   SENSORS_BMP_OSS;
+    int16_t     _ac1, _ac2, _ac3;
+    uint16_t    _ac4, _ac5, _ac6;
+    int16_t     _b1, _b2, _mc, _md;
+    int16_t     _temperature    =   0;
+    long        _pressure       =   0;
+
+    bool        probe();
+    bool        readRegisters(uint8_t reg, uint8_t *data, uint8_t length);
+    bool        writeRegister(uint8_t reg, uint8_t value);
+
+    static long standardPressure(int altitude);
+};
+
+#endif
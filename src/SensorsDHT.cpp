@@ -0,0 +1,197 @@
+//
+//  SensorsDHT
+//  Library C++ code
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <SensorsDHT.h>
+
+SensorsDHT *SensorsDHT::_instance = NULL;
+
+SensorsDHT::SensorsDHT(uint8_t pin)
+{
+    _pin = pin;
+    _interrupt = digitalPinToInterrupt(pin);
+}
+
+bool SensorsDHT::begin()
+{
+    if (_interrupt == (uint8_t)NOT_AN_INTERRUPT) {
+        return false;
+    }
+    _instance = this;
+    pinMode(_pin, INPUT_PULLUP);
+    _state = SENSORS_DHT_IDLE;
+    return true;
+}
+
+// Pull the line low, update() releases it and arms the interrupt
+bool SensorsDHT::start()
+{
+    if (_instance != this || isBusy()) {
+        return false;
+    }
+    if (_lastRead != 0 && millis() - _lastRead < SENSORS_DHT_MIN_INTERVAL) {
+        return false;
+    }
+    reset();
+    _state = SENSORS_DHT_START;
+    _started = micros();
+    _lastRead = millis();
+    digitalWrite(_pin, LOW);
+    pinMode(_pin, OUTPUT);
+    return true;
+}
+
+void SensorsDHT::update()
+{
+    if (_state == SENSORS_DHT_START) {
+        if (micros() - _started >= SENSORS_DHT_START_LOW) {
+            // On AVR our own start signal leaves the interrupt flag set.
+            // It fires on attach, while the state is still START, and is
+            // ignored by isr() instead of being taken for edge 0.
+            attachInterrupt(_interrupt, isr, FALLING);
+            _started = millis();
+            _state = SENSORS_DHT_RECEIVE;
+            pinMode(_pin, INPUT_PULLUP);
+        }
+    } else if (_state == SENSORS_DHT_RECEIVE) {
+        if (millis() - _started > SENSORS_DHT_TIMEOUT) {
+            noInterrupts();
+            if (_state == SENSORS_DHT_RECEIVE) {
+                stop(SENSORS_DHT_ERROR);
+            }
+            interrupts();
+        }
+    }
+}
+
+// Blocking transaction, for setup()
+bool SensorsDHT::read()
+{
+    if (!start()) {
+        return false;
+    }
+    while (isBusy()) {
+        update();
+    }
+    return available();
+}
+
+bool SensorsDHT::isBusy()
+{
+    return _state == SENSORS_DHT_START || _state == SENSORS_DHT_RECEIVE;
+}
+
+bool SensorsDHT::available()
+{
+    return _state == SENSORS_DHT_DONE;
+}
+
+uint8_t SensorsDHT::getErrors()
+{
+    return _errors;
+}
+
+int16_t SensorsDHT::getTemperature()
+{
+    return _temperature;
+}
+
+int16_t SensorsDHT::getHumidity()
+{
+    return _humidity;
+}
+
+void SensorsDHT::reset()
+{
+    _edges = 0;
+    _lastEdge = 0;
+    for (uint8_t i = 0; i < sizeof(_data); i++) {
+        _data[i] = 0;
+    }
+}
+
+// Called with the time since the previous falling edge. Edge 0 is the
+// sensor response, edge 1 ends the 80/80 us preamble and every following
+// edge ends one data bit.
+void SensorsDHT::decode(uint16_t period)
+{
+    if (_edges == 0) {
+        _edges++;
+        return;
+    }
+    if (_edges == 1) {
+        if (period < SENSORS_DHT_PREAMBLE_MIN || period > SENSORS_DHT_PREAMBLE_MAX) {
+            stop(SENSORS_DHT_ERROR);
+            return;
+        }
+        _edges++;
+        return;
+    }
+    if (period < SENSORS_DHT_BIT_MIN || period > SENSORS_DHT_BIT_MAX) {
+        stop(SENSORS_DHT_ERROR);
+        return;
+    }
+    uint8_t bit = _edges - 2;
+    _data[bit >> 3] <<= 1;
+    if (period > SENSORS_DHT_BIT_THRESHOLD) {
+        _data[bit >> 3] |= 1;
+    }
+    if (++_edges == SENSORS_DHT_FRAME_EDGES) {
+        finish();
+    }
+}
+
+void SensorsDHT::finish()
+{
+    uint8_t sum = _data[0] + _data[1] + _data[2] + _data[3];
+    if (sum != _data[4]) {
+        stop(SENSORS_DHT_ERROR);
+        return;
+    }
+    // 0.1 units, temperature is sign and magnitude
+    int16_t humidity = ((uint16_t)_data[0] << 8) | _data[1];
+    int16_t temperature = ((uint16_t)(_data[2] & 0x7F) << 8) | _data[3];
+    if (_data[2] & 0x80) {
+        temperature = -temperature;
+    }
+    if (humidity > 1000) {
+        stop(SENSORS_DHT_ERROR);
+        return;
+    }
+    _humidity = humidity * 10;
+    _temperature = temperature * 10;
+    stop(SENSORS_DHT_DONE);
+}
+
+void SensorsDHT::stop(uint8_t state)
+{
+    detachInterrupt(_interrupt);
+    _state = state;
+    if (state == SENSORS_DHT_ERROR && _errors < 0xFF) {
+        _errors++;
+    }
+}
+
+void SensorsDHT::isr()
+{
+    SensorsDHT *dht = _instance;
+    if (dht == NULL || dht->_state != SENSORS_DHT_RECEIVE) {
+        return;
+    }
+    uint16_t edge = (uint16_t)micros();
+    uint16_t period = edge - dht->_lastEdge;
+    dht->_lastEdge = edge;
+    dht->decode(period);
+}
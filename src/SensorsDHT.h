@@ -0,0 +1,85 @@
+//
+//  SensorsDHT
+//  Header
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Interrupt driven DHT22 (AM2302) reader. The 40 bit frame is decoded
+//  from the falling edges on the data pin, so one transaction returns
+//  temperature and humidity together without disabling interrupts.
+//  The data pin must support attachInterrupt().
+//
+
+#ifndef SensorsDHT_h
+#define SensorsDHT_h
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#define SENSORS_DHT_START_LOW           1100    // us, host start signal
+#define SENSORS_DHT_TIMEOUT             10      // ms, whole frame
+#define SENSORS_DHT_MIN_INTERVAL        2000    // ms, between transactions
+
+// Falling edge to falling edge periods in us
+#define SENSORS_DHT_PREAMBLE_MIN        120     // 80 low + 80 high
+#define SENSORS_DHT_PREAMBLE_MAX        200
+#define SENSORS_DHT_BIT_MIN             50      // 50 low + 26 high = 0
+#define SENSORS_DHT_BIT_THRESHOLD       100     // 50 low + 70 high = 1
+#define SENSORS_DHT_BIT_MAX             160
+
+#define SENSORS_DHT_FRAME_BITS          40
+#define SENSORS_DHT_FRAME_EDGES         (SENSORS_DHT_FRAME_BITS + 2)
+
+#define SENSORS_DHT_IDLE                0
+#define SENSORS_DHT_START               1
+#define SENSORS_DHT_RECEIVE             2
+#define SENSORS_DHT_DONE                3
+#define SENSORS_DHT_ERROR               4
+
+class SensorsDHT
+{
+public:
+    SensorsDHT(uint8_t pin);
+
+    bool begin();
+    bool start();
+    void update();
+    bool read();
+
+    bool isBusy();
+    bool available();
+    uint8_t getErrors();
+
+    int16_t getTemperature();   // 0.01 C
+    int16_t getHumidity();      // 0.01 %RH
+
+    void reset();
+    void decode(uint16_t period);
+
+private:
+    uint8_t             _pin;
+    uint8_t             _interrupt;
+    volatile uint8_t    _state          =   SENSORS_DHT_IDLE;
+    volatile uint8_t    _edges          =   0;
+    volatile uint8_t    _data[5];
+    volatile uint16_t   _lastEdge       =   0;
+    unsigned long       _started        =   0;
+    unsigned long       _lastRead       =   0;
+    uint8_t             _errors         =   0;
+    int16_t             _temperature    =   0;
+    int16_t             _humidity       =   0;
+
+    void        finish();
+    void        stop(uint8_t state);
+
+    static SensorsDHT   *_instance;
+    static void         isr();
+};
+
+#endif
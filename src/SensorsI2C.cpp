@@ -0,0 +1,101 @@
+//
+//  SensorsI2C
+//  Library C++ code
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <SensorsI2C.h>
+
+void SensorsI2C::begin()
+{
+    Wire.begin();
+#ifdef WIRE_HAS_TIMEOUT
+    Wire.setWireTimeout(SENSORS_I2C_TIMEOUT, true);
+#endif
+    check();
+}
+
+// Before a transaction: an idle bus has SDA high
+bool SensorsI2C::check()
+{
+    if (digitalRead(SENSORS_I2C_SDA) == HIGH) {
+        return true;
+    }
+    return recover();
+}
+
+// After a transaction: a timeout leaves the bus in an unknown state
+bool SensorsI2C::timedOut()
+{
+#ifdef WIRE_HAS_TIMEOUT
+    if (Wire.getWireTimeoutFlag()) {
+        Wire.clearWireTimeoutFlag();
+        recover();
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Clock SCL until the device lets go of SDA, then send a STOP and
+// restart Wire
+bool SensorsI2C::recover()
+{
+    if (_faults < 0xFF) {
+        _faults++;
+    }
+#ifdef WIRE_HAS_END
+    Wire.end();
+#endif
+    pinMode(SENSORS_I2C_SDA, INPUT_PULLUP);
+    pinMode(SENSORS_I2C_SCL, INPUT_PULLUP);
+    delayMicroseconds(SENSORS_I2C_HALF_CLOCK);
+    for (uint8_t i = 0; i < SENSORS_I2C_RECOVER_CLOCKS && digitalRead(SENSORS_I2C_SDA) == LOW; i++) {
+        digitalWrite(SENSORS_I2C_SCL, LOW);
+        pinMode(SENSORS_I2C_SCL, OUTPUT);
+        delayMicroseconds(SENSORS_I2C_HALF_CLOCK);
+        pinMode(SENSORS_I2C_SCL, INPUT_PULLUP);
+        if (!releaseClock()) {
+            break;
+        }
+    }
+    digitalWrite(SENSORS_I2C_SDA, LOW);
+    pinMode(SENSORS_I2C_SDA, OUTPUT);
+    delayMicroseconds(SENSORS_I2C_HALF_CLOCK);
+    pinMode(SENSORS_I2C_SDA, INPUT_PULLUP);
+    delayMicroseconds(SENSORS_I2C_HALF_CLOCK);
+    bool released = digitalRead(SENSORS_I2C_SDA) == HIGH && digitalRead(SENSORS_I2C_SCL) == HIGH;
+    Wire.begin();
+#ifdef WIRE_HAS_TIMEOUT
+    Wire.setWireTimeout(SENSORS_I2C_TIMEOUT, true);
+#endif
+    return released;
+}
+
+uint8_t SensorsI2C::getFaults()
+{
+    return _faults;
+}
+
+// Wait a bounded time for a device stretching the clock
+bool SensorsI2C::releaseClock()
+{
+    unsigned long start = micros();
+    while (digitalRead(SENSORS_I2C_SCL) == LOW) {
+        if (micros() - start > SENSORS_I2C_STRETCH) {
+            return false;
+        }
+    }
+    delayMicroseconds(SENSORS_I2C_HALF_CLOCK);
+    return true;
+}
@@ -0,0 +1,53 @@
+//
+//  SensorsI2C
+//  Header
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Keeps the I2C bus from hanging the node. Wire transactions get a
+//  timeout where the core supports it, and a bus held low by a device
+//  is released by clocking SCL and sending a STOP.
+//  Only cores that define WIRE_HAS_TIMEOUT bound a transaction. On the
+//  others there is no guarantee: a device that hangs in the middle of a
+//  transaction still freezes the node, only a bus held low before a
+//  loop tick is recovered.
+//
+
+#ifndef SensorsI2C_h
+#define SensorsI2C_h
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <Wire.h>
+
+#define SENSORS_I2C_SDA                 SDA
+#define SENSORS_I2C_SCL                 SCL
+#define SENSORS_I2C_TIMEOUT             25000   // us per transaction
+#define SENSORS_I2C_HALF_CLOCK          5       // us, 100 kHz
+#define SENSORS_I2C_RECOVER_CLOCKS      9
+#define SENSORS_I2C_STRETCH             1000    // us, clock stretch limit
+
+class SensorsI2C
+{
+public:
+    void begin();
+    bool check();
+    bool timedOut();
+    bool recover();
+
+    uint8_t getFaults();
+
+private:
+    uint8_t     _faults     =   0;
+
+    bool        releaseClock();
+};
+
+#endif
@@ -0,0 +1,152 @@
+//
+//  XBeeFrame
+//  Library C++ code
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <string.h>
+#include <XBeeFrame.h>
+
+XBeeFrame::XBeeFrame(uint8_t *data, uint16_t capacity, bool escaped)
+{
+    _data = data;
+    _capacity = capacity;
+    _escaped = escaped;
+}
+
+// Start delimiter, two bytes kept for the length, then the request header
+void XBeeFrame::begin(uint8_t frameId, uint32_t addressHigh, uint32_t addressLow)
+{
+    _used = 0;
+    _length = 0;
+    _sum = 0;
+    _overflow = _capacity < 3 + XBEE_FRAME_RESERVE;
+    if (_overflow) {
+        return;
+    }
+    _data[_used++] = XBEE_START_DELIMITER;
+    _used += 2;
+    put(XBEE_TX_REQUEST);
+    put(frameId);
+    for (int8_t shift = 24; shift >= 0; shift -= 8) {
+        put(addressHigh >> shift);
+    }
+    for (int8_t shift = 24; shift >= 0; shift -= 8) {
+        put(addressLow >> shift);
+    }
+    put(XBEE_ADDRESS16_UNKNOWN >> 8);
+    put(XBEE_ADDRESS16_UNKNOWN & 0xFF);
+    put(0x00);  // Broadcast radius
+    put(0x00);  // Options
+}
+
+// Adds the checksum and patches the length, returns the frame size
+uint16_t XBeeFrame::end()
+{
+    if (_overflow) {
+        return 0;
+    }
+    putRaw(0xFF - _sum);
+    uint8_t length[4];
+    uint8_t size = writeEscaped(length, _length >> 8);
+    size += writeEscaped(length + size, _length & 0xFF);
+    if (_overflow || _used + size - 2 > _capacity) {
+        _overflow = true;
+        return 0;
+    }
+    if (size > 2) {
+        memmove(_data + 1 + size, _data + 3, _used - 3);
+        _used += size - 2;
+    }
+    memcpy(_data + 1, length, size);
+    return _used;
+}
+
+// Worst case, every byte escaped
+unsigned int XBeeFrame::getFreeSize()
+{
+    if (_overflow || _used + XBEE_FRAME_RESERVE >= _capacity) {
+        return 0;
+    }
+    unsigned int free = _capacity - _used - XBEE_FRAME_RESERVE;
+    return _escaped ? free / 2 : free;
+}
+
+uint16_t XBeeFrame::getSize()
+{
+    return _used;
+}
+
+uint8_t *XBeeFrame::getData()
+{
+    return _data;
+}
+
+bool XBeeFrame::isOverflow()
+{
+    return _overflow;
+}
+
+void XBeeFrame::put(uint8_t value)
+{
+    _sum += value;
+    _length++;
+    putRaw(value);
+}
+
+// Most significant byte first, as ByteBuffer
+void XBeeFrame::putInt(int value)
+{
+    for (int8_t shift = (sizeof(int) - 1) * 8; shift >= 0; shift -= 8) {
+        put((unsigned int)value >> shift);
+    }
+}
+
+void XBeeFrame::putLong(long value)
+{
+    for (int8_t shift = (sizeof(long) - 1) * 8; shift >= 0; shift -= 8) {
+        put((unsigned long)value >> shift);
+    }
+}
+
+void XBeeFrame::putTime(time_t value)
+{
+    for (int8_t shift = (sizeof(time_t) - 1) * 8; shift >= 0; shift -= 8) {
+        put((unsigned long)value >> shift);
+    }
+}
+
+void XBeeFrame::putRaw(uint8_t value)
+{
+    if (_used + 2 > _capacity) {
+        _overflow = true;
+        return;
+    }
+    _used += writeEscaped(_data + _used, value);
+}
+
+bool XBeeFrame::needsEscape(uint8_t value)
+{
+    return _escaped && (value == XBEE_START_DELIMITER || value == XBEE_ESCAPE || value == XBEE_XON || value == XBEE_XOFF);
+}
+
+uint8_t XBeeFrame::writeEscaped(uint8_t *data, uint8_t value)
+{
+    if (needsEscape(value)) {
+        data[0] = XBEE_ESCAPE;
+        data[1] = value ^ XBEE_ESCAPE_XOR;
+        return 2;
+    }
+    data[0] = value;
+    return 1;
+}
@@ -0,0 +1,73 @@
+//
+//  XBeeFrame
+//  Header
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Builds an XBee API transmit request in place. Records are escaped
+//  and summed as they are written, the length is patched in end().
+//  Offers the ByteBuffer calls used by Sensors, so putXBeeData() can
+//  write straight into the frame.
+//
+
+#ifndef XBeeFrame_h
+#define XBeeFrame_h
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <Time.h>
+
+#define XBEE_START_DELIMITER        0x7E
+#define XBEE_ESCAPE                 0x7D
+#define XBEE_XON                    0x11
+#define XBEE_XOFF                   0x13
+#define XBEE_ESCAPE_XOR             0x20
+
+#define XBEE_TX_REQUEST             0x10
+#define XBEE_BROADCAST_HIGH         0x00000000
+#define XBEE_BROADCAST_LOW          0x0000FFFF
+#define XBEE_ADDRESS16_UNKNOWN      0xFFFE
+
+// Room kept free for an escaped checksum and escaped length bytes
+#define XBEE_FRAME_RESERVE          4
+
+class XBeeFrame
+{
+public:
+    XBeeFrame(uint8_t *data, uint16_t capacity, bool escaped = true);
+
+    void begin(uint8_t frameId = 0x01, uint32_t addressHigh = XBEE_BROADCAST_HIGH, uint32_t addressLow = XBEE_BROADCAST_LOW);
+    uint16_t end();
+
+    unsigned int getFreeSize();
+    uint16_t getSize();
+    uint8_t *getData();
+    bool isOverflow();
+
+    void put(uint8_t value);
+    void putInt(int value);
+    void putLong(long value);
+    void putTime(time_t value);
+
+private:
+    uint8_t     *_data;
+    uint16_t    _capacity;
+    bool        _escaped;
+    uint16_t    _used           =   0;
+    uint16_t    _length         =   0;
+    uint8_t     _sum            =   0;
+    bool        _overflow       =   false;
+
+    void        putRaw(uint8_t value);
+    bool        needsEscape(uint8_t value);
+    uint8_t     writeEscaped(uint8_t *data, uint8_t value);
+};
+
+#endif
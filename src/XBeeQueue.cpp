@@ -0,0 +1,103 @@
+//
+//  XBeeQueue
+//  Library C++ code
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <XBeeQueue.h>
+
+XBeeQueue::XBeeQueue(HardwareSerial *serial)
+{
+    _serial = serial;
+}
+
+void XBeeQueue::setAddress(uint32_t addressHigh, uint32_t addressLow)
+{
+    _addressHigh = addressHigh;
+    _addressLow = addressLow;
+}
+
+// Free frame, started and ready for records. NULL while both frames
+// are queued, the caller keeps its data for the next round.
+XBeeFrame *XBeeQueue::acquire()
+{
+    if (_count >= XBEE_QUEUE_FRAMES) {
+        return NULL;
+    }
+    XBeeFrame *frame = &_frames[(_head + _count) % XBEE_QUEUE_FRAMES];
+    if (++_frameId == 0) {
+        _frameId = 1;
+    }
+    frame->begin(_frameId, _addressHigh, _addressLow);
+    _acquired = true;
+    return frame;
+}
+
+bool XBeeQueue::commit()
+{
+    if (!_acquired) {
+        return false;
+    }
+    _acquired = false;
+    if (_frames[(_head + _count) % XBEE_QUEUE_FRAMES].end() == 0) {
+        _dropped++;
+        return false;
+    }
+    _count++;
+    update();
+    return true;
+}
+
+void XBeeQueue::update()
+{
+    while (_count > 0) {
+        int room = _serial->availableForWrite();
+        if (room <= 0) {
+            return;
+        }
+        XBeeFrame *frame = &_frames[_head];
+        uint16_t left = frame->getSize() - _sent;
+        if ((uint16_t)room < left) {
+            left = room;
+        }
+        _serial->write(frame->getData() + _sent, left);
+        _sent += left;
+        if (_sent < frame->getSize()) {
+            return;
+        }
+        _sent = 0;
+        _head = (_head + 1) % XBEE_QUEUE_FRAMES;
+        _count--;
+    }
+}
+
+uint8_t XBeeQueue::getDepth()
+{
+    return _count;
+}
+
+bool XBeeQueue::isFull()
+{
+    return _count >= XBEE_QUEUE_FRAMES;
+}
+
+// For callers that give up on data because the queue is full
+void XBeeQueue::drop()
+{
+    _dropped++;
+}
+
+uint16_t XBeeQueue::getDropped()
+{
+    return _dropped;
+}
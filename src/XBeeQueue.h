@@ -0,0 +1,62 @@
+//
+//  XBeeQueue
+//  Header
+//  ----------------------------------
+//  Developed with embedXcode
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Two XBee API frames: one is filled while the other drains into the
+//  interrupt driven transmit buffer of a HardwareSerial. update() only
+//  writes what the serial can take without blocking.
+//
+
+#ifndef XBeeQueue_h
+#define XBeeQueue_h
+
+#if ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <XBeeFrame.h>
+
+#define XBEE_QUEUE_FRAMES           2
+#define XBEE_QUEUE_FRAME_SIZE       64
+
+class XBeeQueue
+{
+public:
+    XBeeQueue(HardwareSerial *serial);
+
+    void setAddress(uint32_t addressHigh, uint32_t addressLow);
+
+    XBeeFrame *acquire();
+    bool commit();
+    void update();
+
+    uint8_t getDepth();
+    bool isFull();
+    void drop();
+    uint16_t getDropped();
+
+private:
+    HardwareSerial  *_serial;
+    uint8_t         _data[XBEE_QUEUE_FRAMES][XBEE_QUEUE_FRAME_SIZE];
+    XBeeFrame       _frames[XBEE_QUEUE_FRAMES] = {
+        XBeeFrame(_data[0], XBEE_QUEUE_FRAME_SIZE),
+        XBeeFrame(_data[1], XBEE_QUEUE_FRAME_SIZE)
+    };
+    uint32_t        _addressHigh    =   XBEE_BROADCAST_HIGH;
+    uint32_t        _addressLow     =   XBEE_BROADCAST_LOW;
+    uint8_t         _frameId        =   0;
+    uint8_t         _head           =   0;
+    uint8_t         _count          =   0;
+    uint16_t        _sent           =   0;
+    uint16_t        _dropped        =   0;
+    bool            _acquired       =   false;
+};
+
+#endif
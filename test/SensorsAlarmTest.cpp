@@ -0,0 +1,78 @@
+//
+//  SensorsAlarmTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Alarm rules: a rule needs exactly one direction and every event
+//  stays pending until it has been sent.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define private public
+#include <Sensors.h>
+#undef private
+
+JRTC RTC;
+
+void reset() {}
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static void sample(Sensors *sensors, int humidity)
+{
+    sensors->_humidityDHT = humidity;
+    sensors->loopAlarms();
+}
+
+int main()
+{
+    Sensors sensors;
+    sensors.setup();
+
+    // No direction, both directions and unknown channels are refused
+    CHECK(!sensors.addAlarm(SENSORS_CHANNEL_HUMIDITY_DHT, 0, 8000, 500));
+    CHECK(!sensors.addAlarm(SENSORS_CHANNEL_HUMIDITY_DHT, SENSORS_ALARM_ABOVE | SENSORS_ALARM_BELOW, 8000, 500));
+    CHECK(!sensors.addAlarm(SENSORS_CHANNELS, SENSORS_ALARM_ABOVE, 8000, 500));
+    CHECK(sensors._alarmCount == 0);
+    CHECK(sensors.addAlarm(SENSORS_CHANNEL_HUMIDITY_DHT, SENSORS_ALARM_ABOVE, 8000, 500));
+    SensorsAlarm *alarm = &sensors._alarms[0];
+
+    sample(&sensors, 7000);
+    CHECK(!sensors.hasAlarms());
+
+    // Raised and cleared again before anything was sent: both are kept
+    sample(&sensors, 8500);
+    CHECK(alarm->pending == SENSORS_ALARM_RAISED);
+    sample(&sensors, 7000);
+    CHECK(alarm->pending == (SENSORS_ALARM_RAISED | SENSORS_ALARM_CLEARED));
+    CHECK(!(alarm->flags & SENSORS_ALARM_ACTIVE));
+
+    ByteBuffer buffer;
+    buffer.init(256);
+    CHECK(sensors.putXBeeAlarms(&buffer) == 2);
+    CHECK(!sensors.hasAlarms());
+
+    // Within the hysteresis nothing changes
+    sample(&sensors, 8500);
+    sample(&sensors, 7800);
+    CHECK(alarm->pending == SENSORS_ALARM_RAISED);
+    CHECK(alarm->flags & SENSORS_ALARM_ACTIVE);
+
+    // An alarm that does not fit stays pending
+    buffer.init(XBEE_TIME_RECORD_SIZE);
+    CHECK(sensors.putXBeeAlarms(&buffer) == 1);
+    CHECK(alarm->pending == SENSORS_ALARM_RAISED);
+
+    if (failures == 0) {
+        printf("SensorsAlarmTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
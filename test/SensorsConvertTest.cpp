@@ -0,0 +1,126 @@
+//
+//  SensorsConvertTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Every path this CPU has against double precision references, at
+//  batch sizes that leave every possible tail. Lux is checked against
+//  the integer calculation of the TSL2561 driver.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <SensorsConvert.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+// calculateLux() of the driver at 13 ms and 16x, T package
+static uint32_t driverLux(uint16_t ch0, uint16_t ch1)
+{
+    static const uint16_t k[8] = { 0x0040, 0x0080, 0x00C0, 0x0100, 0x0138, 0x019A, 0x029A, 0x029A };
+    static const uint16_t b[8] = { 0x01F2, 0x0214, 0x023F, 0x0270, 0x016F, 0x00D2, 0x0018, 0x0000 };
+    static const uint16_t m[8] = { 0x01BE, 0x02D1, 0x037B, 0x03FE, 0x01FC, 0x00FB, 0x0012, 0x0000 };
+    unsigned long channel0 = (ch0 * 0x7517UL) >> 10;
+    unsigned long channel1 = (ch1 * 0x7517UL) >> 10;
+    unsigned long ratio = 0;
+    if (channel0 != 0) {
+        ratio = (((channel1 << 10) / channel0) + 1) >> 1;
+    }
+    uint8_t segment = 7;
+    for (uint8_t i = 0; i < 8; i++) {
+        if (ratio <= k[i]) {
+            segment = i;
+            break;
+        }
+    }
+    long temp = (long)(channel0 * b[segment]) - (long)(channel1 * m[segment]);
+    if (temp < 0) {
+        temp = 0;
+    }
+    temp += 1 << 13;
+    return temp >> 14;
+}
+
+static bool near(float value, double expected, double tolerance)
+{
+    if (isnan(expected)) {
+        return isnan(value);
+    }
+    return fabs(value - expected) <= tolerance;
+}
+
+int main()
+{
+    const size_t size = 1037;
+    std::vector<int32_t> temperature(size), humidity(size), pressure(size), full(size), ir(size);
+    srand(38);
+    for (size_t i = 0; i < size; i++) {
+        temperature[i] = rand() % 12500 - 4000;
+        humidity[i] = i % 97 == 0 ? 0 : 1 + rand() % 10000;
+        pressure[i] = 80000 + rand() % 30000;
+        full[i] = i % 89 == 0 ? 0 : (rand() % 2000) * SENSORS_FLOAT_TO_INT_MULTIPLY;
+        ir[i] = full[i] == 0 ? (rand() % 10) * SENSORS_FLOAT_TO_INT_MULTIPLY : (rand() % (full[i] / SENSORS_FLOAT_TO_INT_MULTIPLY + 1)) * SENSORS_FLOAT_TO_INT_MULTIPLY;
+    }
+
+    for (uint8_t path = SENSORS_CONVERT_SCALAR; path <= SENSORS_CONVERT_AVX2; path++) {
+        SensorsConvert convert;
+        if (!convert.setPath(path)) {
+            printf("SensorsConvertTest path %d not on this CPU\n", path);
+            continue;
+        }
+        CHECK(convert.getPath() == path);
+        for (size_t count = 0; count <= size; count += count < 40 ? 1 : 333) {
+            std::vector<float> result(count + 1, -1.0f);
+            convert.toFloat(&temperature[0], &result[0], count);
+            for (size_t i = 0; i < count; i++) {
+                CHECK(result[i] == (float)temperature[i] / 100.0f);
+            }
+            CHECK(result[count] == -1.0f);
+
+            convert.pressure(&pressure[0], &result[0], count, SENSORS_PRESSURE_INHG);
+            for (size_t i = 0; i < count; i++) {
+                CHECK(near(result[i], pressure[i] / 3386.389, 1e-3));
+            }
+            CHECK(result[count] == -1.0f);
+
+            convert.dewPoint(&temperature[0], &humidity[0], &result[0], count);
+            for (size_t i = 0; i < count; i++) {
+                double celsius = temperature[i] / 100.0;
+                double gamma = 17.271 * celsius / (237.7 + celsius) + log(humidity[i] / 10000.0);
+                CHECK(near(result[i], 237.7 * gamma / (17.271 - gamma), 2e-3));
+            }
+            CHECK(result[count] == -1.0f);
+
+            convert.lux(&full[0], &ir[0], &result[0], count);
+            for (size_t i = 0; i < count; i++) {
+                uint32_t expected = driverLux(full[i] / SENSORS_FLOAT_TO_INT_MULTIPLY, ir[i] / SENSORS_FLOAT_TO_INT_MULTIPLY);
+                CHECK(near(result[i], expected, 1.0 + expected * 0.01));
+            }
+            CHECK(result[count] == -1.0f);
+        }
+    }
+
+    SensorsRecord records[3] = {
+        { 1, 10, 2150, XBEE_TEMPERATURE_HEADER | 0x02, 0, 0, 0 },
+        { 1, 10, 6520, XBEE_HUMIDITY_HEADER | 0x01, 0, 0, 0 },
+        { 1, 70, 2160, XBEE_TEMPERATURE_HEADER | 0x02, 0, 0, 0 }
+    };
+    int64_t times[3];
+    int32_t values[3];
+    CHECK(SensorsConvert::gather(records, 3, XBEE_TEMPERATURE_HEADER | 0x02, times, values) == 2);
+    CHECK(times[1] == 70 && values[1] == 2160);
+
+    if (failures == 0) {
+        printf("SensorsConvertTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,71 @@
+//
+//  SensorsDHTTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Feeds decode() the falling edge periods of a DHT22 frame: a clean
+//  frame, the same frame with +-19 us jitter and one with a bad checksum.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SensorsDHT.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+// 65.2 %RH, -10.1 C
+static const uint8_t frame[5] = { 0x02, 0x8C, 0x80, 0x65, 0x73 };
+
+static void send(SensorsDHT *dht, const uint8_t *data, int jitter)
+{
+    dht->reset();
+    dht->decode(0);                 // Response
+    dht->decode(160 + jitter);      // Preamble
+    for (uint8_t bit = 0; bit < SENSORS_DHT_FRAME_BITS; bit++) {
+        bool one = data[bit >> 3] & (0x80 >> (bit & 7));
+        int offset = jitter == 0 ? 0 : (bit & 1 ? jitter : -jitter);
+        dht->decode((one ? 120 : 76) + offset);
+    }
+}
+
+int main()
+{
+    SensorsDHT dht(2);
+    CHECK(dht.begin());
+
+    send(&dht, frame, 0);
+    CHECK(dht.available());
+    CHECK(dht.getHumidity() == 6520);
+    CHECK(dht.getTemperature() == -1010);
+
+    send(&dht, frame, 19);
+    CHECK(dht.available());
+    CHECK(dht.getHumidity() == 6520);
+    CHECK(dht.getTemperature() == -1010);
+
+    uint8_t corrupt[5];
+    memcpy(corrupt, frame, sizeof(corrupt));
+    corrupt[4] ^= 0x01;
+    send(&dht, corrupt, 0);
+    CHECK(!dht.available());
+    CHECK(dht.getErrors() == 1);
+    CHECK(dht.getHumidity() == 6520);
+
+    dht.reset();
+    dht.decode(0);
+    dht.decode(40);                 // Too short for the preamble
+    CHECK(!dht.available());
+    CHECK(dht.getErrors() == 2);
+
+    if (failures == 0) {
+        printf("SensorsDHTTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,79 @@
+//
+//  SensorsI2CTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Runs Sensors::loop() against a fake Wire that holds SDA low or lets
+//  every transaction run into the timeout. loop() has to return, count
+//  the fault and stay within a bounded time.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Sensors.h>
+
+JRTC RTC;
+
+static int resets = 0;
+
+void reset()
+{
+    resets++;
+}
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+// One loop tick, returns its duration in us
+static unsigned long tick(Sensors *sensors)
+{
+    hostMicros += (SENSORS_LOOP_CHECK + 1) * 1000UL;
+    unsigned long start = hostMicros;
+    sensors->loop();
+    return hostMicros - start;
+}
+
+int main()
+{
+    Sensors sensors;
+    sensors.setup();
+    CHECK(sensors.isSetup());
+    CHECK(sensors.getI2CFaults() == 0);
+    for (uint8_t i = 0; i < 8; i++) {
+        tick(&sensors);
+    }
+    CHECK(sensors.getI2CFaults() == 0);
+
+    // A device holds SDA low between transactions
+    hostSda = LOW;
+    tick(&sensors);
+    hostSda = HIGH;
+    CHECK(sensors.getI2CFaults() == 1);
+
+    // Every transaction hangs until the Wire timeout
+    hostWireHang = true;
+    unsigned long worst = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        unsigned long duration = tick(&sensors);
+        if (duration > worst) {
+            worst = duration;
+        }
+    }
+    hostWireHang = false;
+    CHECK(sensors.getI2CFaults() >= 2);
+    CHECK(worst >= SENSORS_I2C_TIMEOUT);
+    CHECK(worst < 2 * SENSORS_I2C_TIMEOUT);
+    CHECK(resets == 0);
+    printf("SensorsI2CTest worst loop %lu us, %u faults\n", worst, sensors.getI2CFaults());
+
+    if (failures == 0) {
+        printf("SensorsI2CTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,299 @@
+//
+//  SensorsPipelineTest
+//  Host test
+//  ----------------------------------
+//
+//  The queues under threads, the frame splitter on escaped, broken and
+//  raw streams, and a file through the whole pipeline: every record
+//  must arrive once, in order per node, also when the sink is slow.
+//
+
+#include <chrono>
+#include <fcntl.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <SensorsPipeline.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+#define TEST_ITEMS      200000
+#define TEST_THREADS    4
+
+static void testSpscQueue()
+{
+    SensorsSpscQueue<uint32_t> queue(100);
+    CHECK(queue.getCapacity() == 128);
+    bool ordered = true;
+    std::thread consumer([&queue, &ordered]() {
+        uint32_t items[17];
+        uint32_t expected = 0;
+        while (expected < TEST_ITEMS) {
+            size_t count = queue.pop(items, 17);
+            for (size_t i = 0; i < count; i++) {
+                ordered = ordered && items[i] == expected++;
+            }
+        }
+    });
+    uint32_t items[23];
+    uint32_t next = 0;
+    while (next < TEST_ITEMS) {
+        size_t count = 1 + next % 23;
+        if (count > TEST_ITEMS - next) {
+            count = TEST_ITEMS - next;
+        }
+        for (size_t i = 0; i < count; i++) {
+            items[i] = next + i;
+        }
+        next += queue.push(items, count);
+    }
+    consumer.join();
+    CHECK(ordered);
+    CHECK(queue.getDepth() == 0);
+
+    // A full queue takes what fits
+    uint32_t many[200] = { 0 };
+    CHECK(queue.push(many, 200) == 128);
+    CHECK(queue.push(many, 1) == 0);
+    CHECK(queue.pop(many, 200) == 128);
+}
+
+static void testMpmcQueue()
+{
+    SensorsMpmcQueue<uint32_t> queue(64);
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint32_t> popped{0};
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < TEST_THREADS; t++) {
+        threads.push_back(std::thread([&queue, t]() {
+            for (uint32_t i = t; i < TEST_ITEMS; i += TEST_THREADS) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+        threads.push_back(std::thread([&queue, &sum, &popped]() {
+            uint32_t item;
+            while (popped.load() < TEST_ITEMS) {
+                if (queue.pop(&item)) {
+                    sum += item;
+                    popped++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    CHECK(popped.load() == TEST_ITEMS);
+    CHECK(sum.load() == (uint64_t)TEST_ITEMS * (TEST_ITEMS - 1) / 2);
+    uint32_t item;
+    CHECK(!queue.pop(&item));
+    for (uint32_t i = 0; i < 64; i++) {
+        queue.push(i);
+    }
+    CHECK(!queue.push(64));
+    CHECK(queue.getDepth() == 64);
+}
+
+static size_t putPayload(uint8_t *payload, uint32_t time, int32_t value)
+{
+    size_t size = sensorsPutTime(payload, time);
+    size += sensorsPutValue(payload + size, XBEE_TEMPERATURE_HEADER | 0x01, value);
+    size += sensorsPutValue(payload + size, XBEE_LUX_HEADER | 0x02, value * 1000);
+    return size;
+}
+
+static size_t putAll(SensorsFrameSplitter *splitter, const uint8_t *data, size_t size, std::vector<SensorsFrame> *frames)
+{
+    SensorsFrame frame;
+    for (size_t i = 0; i < size; i++) {
+        if (splitter->put(data[i], 1, &frame)) {
+            frames->push_back(frame);
+        }
+    }
+    return frames->size();
+}
+
+static void testSplitter()
+{
+    // Address, value and sum with bytes that must be escaped
+    uint8_t payload[64];
+    size_t size = putPayload(payload, 0x7E7D1113, 0x117E);
+    uint8_t stream[512];
+    uint64_t node = 0x0013A2004011137EULL;
+    size_t used = sensorsPutFrame(stream, node, payload, size);
+    CHECK(used > XBEE_RX_PACKET_HEADER + size + 4);
+    for (size_t i = 1; i < used; i++) {
+        CHECK(stream[i] != XBEE_START_DELIMITER);
+    }
+    // A frame cut off by the next start, then a bad sum
+    size_t broken = used;
+    stream[broken++] = XBEE_START_DELIMITER;
+    stream[broken++] = 0x00;
+    stream[broken++] = 0x05;
+    stream[broken++] = XBEE_RX_PACKET;
+    broken += sensorsPutFrame(stream + broken, node, payload, size);
+    stream[broken - 1] ^= 0x01;
+    // A transmit status is not data
+    const uint8_t status[] = { XBEE_START_DELIMITER, 0x00, 0x07, 0x8B, 0x01, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0x76 };
+    memcpy(stream + broken, status, sizeof(status));
+    broken += sizeof(status);
+    size_t total = broken + sensorsPutFrame(stream + broken, node + 1, payload, size);
+
+    SensorsFrameSplitter splitter;
+    std::vector<SensorsFrame> frames;
+    CHECK(putAll(&splitter, stream, total, &frames) == 2);
+    CHECK(frames[0].node == node && frames[1].node == node + 1);
+    CHECK(frames[0].size == size && memcmp(frames[0].data, payload, size) == 0);
+    CHECK(frames[1].size == size && memcmp(frames[1].data, payload, size) == 0);
+    CHECK(splitter.getErrors() == 2);
+    CHECK(splitter.getIgnored() == 1);
+    SensorsFrame frame;
+    CHECK(!splitter.flush(1, &frame));
+
+    // Without escaping, a transmit request gets the configured node
+    uint8_t plain[128];
+    size_t length = XBEE_TX_REQUEST_HEADER + size;
+    plain[0] = XBEE_START_DELIMITER;
+    plain[1] = length >> 8;
+    plain[2] = length & 0xFF;
+    memset(plain + 3, 0, XBEE_TX_REQUEST_HEADER);
+    plain[3] = XBEE_TX_REQUEST;
+    memcpy(plain + 3 + XBEE_TX_REQUEST_HEADER, payload, size);
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += plain[3 + i];
+    }
+    plain[3 + length] = 0xFF - sum;
+    SensorsFrameSplitter api(SENSORS_FRAME_API, 42);
+    frames.clear();
+    CHECK(putAll(&api, plain, length + 4, &frames) == 1);
+    CHECK(frames[0].node == 42 && frames[0].size == size && memcmp(frames[0].data, payload, size) == 0);
+    // Cut off at the end of the stream
+    CHECK(putAll(&api, plain, length, &frames) == 1);
+    CHECK(!api.flush(1, &frame) && api.getErrors() == 1);
+
+    // Raw: cut in front of every snapshot, a stale record stays with its time
+    uint8_t raw[128];
+    size_t first = putPayload(raw, 1000, 1);
+    raw[first] = XBEE_STALE_HEADER;
+    size_t second = first + 1 + putPayload(raw + first + 1, 1060, 2);
+    size_t third = second + putPayload(raw + second, 1120, 3);
+    SensorsFrameSplitter direct(SENSORS_FRAME_RAW, 7);
+    frames.clear();
+    CHECK(putAll(&direct, raw, third, &frames) == 2);
+    CHECK(direct.flush(1, &frame));
+    frames.push_back(frame);
+    CHECK(frames[0].node == 7 && frames[0].size == first);
+    CHECK(frames[1].size == second - first && frames[1].data[0] == XBEE_STALE_HEADER);
+    CHECK(frames[2].size == third - second && memcmp(frames[2].data, raw + second, frames[2].size) == 0);
+    CHECK(direct.getErrors() == 0);
+}
+
+class TestSink : public SensorsSink
+{
+public:
+    std::vector<SensorsRecord>  records;
+    unsigned int                delay       =   0;
+    bool                        flushed     =   false;
+
+    void write(const SensorsRecord *items, size_t count)
+    {
+        records.insert(records.end(), items, items + count);
+        if (delay > 0) {
+            delay--;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    void flush()
+    {
+        flushed = true;
+    }
+};
+
+static void testPipeline(uint8_t workers, unsigned int delay)
+{
+    const size_t nodes = 37;
+    const size_t payloads = 20000;
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < payloads; i++) {
+        uint8_t payload[64];
+        size_t size = putPayload(payload, 1571443200 + (i / nodes) * 60, i);
+        uint8_t frame[256];
+        stream.insert(stream.end(), frame, frame + sensorsPutFrame(frame, 0x0013A20040000000ULL + i % nodes, payload, size));
+    }
+    char file[] = "/tmp/SensorsPipelineTest-XXXXXX";
+    int fd = mkstemp(file);
+    CHECK(write(fd, &stream[0], stream.size()) == (ssize_t)stream.size());
+    lseek(fd, 0, SEEK_SET);
+
+    TestSink sink;
+    sink.delay = delay;
+    SensorsPipeline pipeline(workers);
+    pipeline.addSink(&sink);
+    CHECK(pipeline.start(fd));
+    CHECK(!pipeline.start(fd));
+    pipeline.join();
+    CHECK(!pipeline.isRunning());
+    close(fd);
+    unlink(file);
+
+    CHECK(sink.flushed);
+    CHECK(sink.records.size() == payloads * 2);
+    std::map<uint64_t, int32_t> last;
+    bool ordered = true;
+    for (size_t i = 0; i < sink.records.size(); i++) {
+        const SensorsRecord *record = &sink.records[i];
+        if (record->sensor != (XBEE_TEMPERATURE_HEADER | 0x01)) {
+            continue;
+        }
+        std::map<uint64_t, int32_t>::iterator entry = last.find(record->node);
+        ordered = ordered && (entry == last.end() || record->value > entry->second);
+        ordered = ordered && (uint64_t)record->value % nodes == record->node - 0x0013A20040000000ULL;
+        last[record->node] = record->value;
+    }
+    CHECK(ordered);
+    CHECK(last.size() == nodes);
+
+    SensorsPipelineMetrics metrics = pipeline.getMetrics();
+    CHECK(metrics.seconds > 0);
+    CHECK(metrics.stages[SENSORS_STAGE_READER].items == stream.size());
+    CHECK(metrics.stages[SENSORS_STAGE_SPLITTER].items == payloads);
+    CHECK(metrics.stages[SENSORS_STAGE_DECODER].items == payloads * 2);
+    CHECK(metrics.stages[SENSORS_STAGE_SINK].items == payloads * 2);
+    for (uint8_t stage = 0; stage < SENSORS_STAGES; stage++) {
+        CHECK(metrics.stages[stage].errors == 0);
+        CHECK(metrics.stages[stage].depth == 0);
+    }
+    CHECK(metrics.stages[SENSORS_STAGE_DECODER].capacity >= workers * SENSORS_PIPELINE_BATCHES);
+    // The slow sink held every batch: the decoders had to wait
+    if (delay > 0) {
+        CHECK(metrics.stages[SENSORS_STAGE_DECODER].stalls > 0);
+    }
+}
+
+int main()
+{
+    testSpscQueue();
+    testMpmcQueue();
+    testSplitter();
+    testPipeline(1, 0);
+    testPipeline(3, 0);
+    testPipeline(4, 40);
+    if (failures == 0) {
+        printf("SensorsPipelineTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,126 @@
+//
+//  SensorsRollupTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Three days of records every 30 s, shuffled as batched frames arrive,
+//  with a backfill of old records at the end and some stale ones. The
+//  buckets and summaries must match a plain pass over the records.
+//
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <SensorsRollup.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+#define TEST_START      1571443200      // Midnight
+#define TEST_SENSOR     (XBEE_TEMPERATURE_HEADER | 0x01)
+
+static SensorsRollupBucket expect(const std::vector<SensorsRecord> &records, uint64_t node, int64_t from, int64_t to)
+{
+    SensorsRollupBucket bucket = { from, 0, 0, 0, 0 };
+    for (size_t i = 0; i < records.size(); i++) {
+        const SensorsRecord *record = &records[i];
+        if (record->node == node && !(record->flags & SENSORS_RECORD_STALE) && record->time >= from && record->time < to) {
+            SensorsRollupBucket one = { record->time, record->value, record->value, record->value, 1 };
+            bucket.merge(one);
+        }
+    }
+    return bucket;
+}
+
+static bool same(const SensorsRollupBucket &a, const SensorsRollupBucket &b)
+{
+    return a.count == b.count && a.sum == b.sum && (a.count == 0 || (a.min == b.min && a.max == b.max));
+}
+
+int main()
+{
+    std::vector<SensorsRecord> records;
+    srand(30);
+    for (int64_t time = TEST_START; time < TEST_START + 3 * 86400; time += 30) {
+        for (uint64_t node = 1; node <= 2; node++) {
+            SensorsRecord record = { node, time + rand() % 5, 2000 + rand() % 400 - 200, TEST_SENSOR, 0, 0, 0 };
+            if (rand() % 50 == 0) {
+                record.flags = SENSORS_RECORD_STALE;
+            }
+            records.push_back(record);
+        }
+    }
+    // Batches of frames arrive out of order, hours 40 to 42 are backfilled
+    // last: too old for the minutes but not for the hours
+    std::vector<SensorsRecord> arrival;
+    std::vector<SensorsRecord> backfill;
+    for (size_t i = 0; i < records.size(); i++) {
+        int64_t hour = (records[i].time - TEST_START) / 3600;
+        (hour >= 40 && hour < 42 ? backfill : arrival).push_back(records[i]);
+    }
+    for (size_t i = 0; i + 400 <= arrival.size(); i += 400) {
+        std::random_shuffle(arrival.begin() + i, arrival.begin() + i + 400);
+    }
+    arrival.insert(arrival.end(), backfill.begin(), backfill.end());
+
+    SensorsRollup rollup;
+    rollup.update(&arrival[0], arrival.size());
+    CHECK(rollup.getSeries() == 2);
+    CHECK(rollup.getLate() >= backfill.size() * 9 / 10);
+    size_t stale = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        stale += records[i].flags & SENSORS_RECORD_STALE ? 1 : 0;
+    }
+    CHECK(rollup.getStale() == stale);
+
+    // Every bucket each ring still holds
+    const int64_t end = TEST_START + 3 * 86400;
+    const int64_t seconds[3] = { SENSORS_ROLLUP_MINUTE, SENSORS_ROLLUP_HOUR, SENSORS_ROLLUP_DAY };
+    const int64_t buckets[3] = { SENSORS_ROLLUP_MINUTES, SENSORS_ROLLUP_HOURS, SENSORS_ROLLUP_DAYS };
+    for (uint8_t level = 0; level < 3; level++) {
+        std::vector<SensorsRollupBucket> found;
+        int64_t from = std::max((int64_t)TEST_START, end - buckets[level] * seconds[level]);
+        CHECK(rollup.query(1, TEST_SENSOR, level, from, end, &found) == (size_t)((end - from) / seconds[level]));
+        for (size_t i = 0; i < found.size(); i++) {
+            CHECK(found[i].start == from + (int64_t)i * seconds[level]);
+            CHECK(same(found[i], expect(records, 1, found[i].start, found[i].start + seconds[level])));
+        }
+    }
+    std::vector<SensorsRollupBucket> found;
+    CHECK(rollup.query(3, TEST_SENSOR, 0, TEST_START, end, &found) == 0);
+
+    // Summaries over minutes, hours and days, the edges rounded to minutes
+    const int64_t ranges[4][2] = {
+        { end - 5400 + 420, end },
+        { end - 40 * 3600, end - 3600 },
+        { TEST_START, end - 86400 },
+        { end - 30 * 3600, end - 7200 + 59 }
+    };
+    for (uint8_t r = 0; r < 4; r++) {
+        for (uint64_t node = 1; node <= 2; node++) {
+            SensorsRollupBucket summary;
+            CHECK(rollup.summarize(node, TEST_SENSOR, ranges[r][0], ranges[r][1], &summary));
+            int64_t to = (ranges[r][1] + 59) / 60 * 60;
+            SensorsRollupBucket expected = expect(records, node, ranges[r][0], to);
+            CHECK(same(summary, expected));
+            CHECK(summary.count > 0 && summary.getMean() == expected.getMean());
+        }
+    }
+
+    // An edge in minutes the ring no longer holds
+    SensorsRollupBucket summary;
+    CHECK(!rollup.summarize(1, TEST_SENSOR, TEST_START + 600, end, &summary));
+    CHECK(summary.count > 0);
+
+    if (failures == 0) {
+        printf("SensorsRollupTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,76 @@
+//
+//  SensorsSnapshotTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Warm restarts with Sensors_snapshot: a sensor that died or an RTC
+//  that lost its time must not come back as good from the EEPROM.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define private public
+#include <Sensors.h>
+#undef private
+
+JRTC RTC;
+EEPROMClass EEPROM;
+
+void reset() {}
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static void run(Sensors *sensors, uint8_t ticks)
+{
+    for (uint8_t i = 0; i < ticks; i++) {
+        hostMicros += (SENSORS_LOOP_CHECK + 1) * 1000UL;
+        sensors->loop();
+    }
+}
+
+int main()
+{
+    Sensors cold;
+    cold.setup();
+    run(&cold, 8);
+    CHECK(bitRead(cold._status, SENSORS_BMP_SETUP_BIT));
+    CHECK(bitRead(cold._status, SENSORS_TIME_SETUP_BIT));
+    CHECK(cold.getPressure() != 0);
+    CHECK(cold.saveSnapshot());
+
+    // Same hardware: everything resumes, the readings are stale
+    Sensors warm;
+    warm.setup();
+    CHECK(warm.isStale());
+    CHECK(bitRead(warm._status, SENSORS_BMP_SETUP_BIT));
+    CHECK(warm.getPressure() == cold.getPressure());
+    run(&warm, 8);
+    CHECK(!warm.isStale());
+
+    // The BMP180 died and the RTC lost its time during the restart
+    hostWireAbsent = true;
+    hostTimeSet = false;
+    Sensors dead;
+    dead.setup();
+    CHECK(!bitRead(dead._status, SENSORS_BMP_SETUP_BIT));
+    CHECK(!bitRead(dead._status, SENSORS_TEMPERATURE_BMP_SETUP_BIT));
+    CHECK(!bitRead(dead._status, SENSORS_TIME_SETUP_BIT));
+    CHECK(!bitRead(dead._status, SENSORS_TEMPERATURE_RTC_SETUP_BIT));
+    CHECK(dead.getPressure() == 0);
+    run(&dead, 8);
+    CHECK(dead.getPressure() == 0);
+    hostWireAbsent = false;
+    hostTimeSet = true;
+
+    if (failures == 0) {
+        printf("SensorsSnapshotTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+//
+//  SensorsStoreTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Decodes payloads in the node format and stores the records: every
+//  range scan must return what a plain filter over the records returns,
+//  before and after the store is closed and opened again.
+//
+
+#include <algorithm>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <SensorsStore.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static void testDecoder()
+{
+    uint8_t payload[64];
+    size_t size = 0;
+    payload[size++] = XBEE_STALE_HEADER;
+    size += sensorsPutTime(payload + size, 1571443200);
+    size += sensorsPutValue(payload + size, XBEE_TEMPERATURE_HEADER | 0x02, -1010);
+    payload[size++] = XBEE_ALARM_HEADER;
+    payload[size++] = 3;
+    payload[size++] = 0x81;
+    size += sensorsPutValue(payload + size, XBEE_HUMIDITY_HEADER | 0x01, 6520);
+    size += sensorsPutValue(payload + size, XBEE_LUX_HEADER | 0x02, 12345678);
+    CHECK(sensorsPutValue(payload + size, 0x1F << 3, 0) == 0);
+
+    SensorsDecoder decoder;
+    SensorsRecord records[16];
+    CHECK(decoder.decode(7, payload, size, 99, records, 16) == 3);
+    CHECK(records[0].node == 7 && records[0].time == 1571443200);
+    CHECK(records[0].sensor == (XBEE_TEMPERATURE_HEADER | 0x02) && records[0].value == -1010);
+    CHECK(records[0].flags == SENSORS_RECORD_STALE);
+    CHECK(records[1].value == 6520 && records[1].alarm == 0x81 && records[1].channel == 3);
+    CHECK(records[1].flags == (SENSORS_RECORD_STALE | SENSORS_RECORD_ALARM));
+    CHECK(records[2].value == 12345678 && records[2].flags == SENSORS_RECORD_STALE);
+
+    // Cut off in the last value: the records before it are kept
+    CHECK(decoder.decode(7, payload, size - 1, 99, records, 16) == 2);
+    CHECK(decoder.getTruncated() == 1);
+    // Without a time record the arrival time is used
+    CHECK(decoder.decode(7, payload + 6, 4, 99, records, 16) == 1);
+    CHECK(records[0].time == 99 && records[0].flags == SENSORS_RECORD_ARRIVAL);
+    // An unknown header stops the payload
+    uint8_t unknown[6] = { XBEE_SENSOR_HEADER, 0x1F << 3, 0, 0, 0, 0 };
+    CHECK(decoder.decode(7, unknown, sizeof(unknown), 99, records, 16) == 0);
+    CHECK(decoder.getMalformed() == 1);
+}
+
+static void removeDirectory(const std::string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            unlink((directory + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+static void checkScans(SensorsStore *store, const std::vector<SensorsRecord> &records)
+{
+    static const int64_t ranges[5][2] = {
+        { INT64_MIN, INT64_MAX }, { 1000, 1600 }, { 5000, 5001 }, { 0, 1 }, { 90000, 100000 }
+    };
+    for (uint8_t r = 0; r < 5; r++) {
+        for (uint64_t node = 1; node <= 3; node++) {
+            std::vector<int64_t> times;
+            std::vector<int32_t> values;
+            size_t found = store->scan(node, XBEE_TEMPERATURE_HEADER | 0x01, ranges[r][0], ranges[r][1], &times, &values);
+            std::vector<int64_t> expectedTimes;
+            std::vector<int32_t> expectedValues;
+            for (size_t i = 0; i < records.size(); i++) {
+                if (records[i].node == node && records[i].time >= ranges[r][0] && records[i].time < ranges[r][1]) {
+                    expectedTimes.push_back(records[i].time);
+                    expectedValues.push_back(records[i].value);
+                }
+            }
+            // Same points, blocks may come back in another order than stored
+            CHECK(found == expectedTimes.size());
+            std::vector<std::pair<int64_t, int32_t> > got, expected;
+            for (size_t i = 0; i < found; i++) {
+                got.push_back(std::make_pair(times[i], values[i]));
+                expected.push_back(std::make_pair(expectedTimes[i], expectedValues[i]));
+            }
+            std::sort(got.begin(), got.end());
+            std::sort(expected.begin(), expected.end());
+            CHECK(got == expected);
+        }
+    }
+}
+
+static void testStore()
+{
+    char temporary[] = "/tmp/SensorsStoreTest-XXXXXX";
+    std::string directory = mkdtemp(temporary);
+
+    // Regular minutes, a late backfill, jumps and extreme values
+    std::vector<SensorsRecord> records;
+    srand(29);
+    for (int i = 0; i < 5000; i++) {
+        SensorsRecord record = { (uint64_t)(1 + i % 3), 1000 + (i / 3) * 60, 2000 + rand() % 50, XBEE_TEMPERATURE_HEADER | 0x01, 0, 0, 0 };
+        if (i % 997 == 0) {
+            record.time -= 3600 * 24;
+        }
+        if (i % 1001 == 0) {
+            record.time += 1LL << 40;
+            record.value = i & 1 ? INT32_MIN : INT32_MAX;
+        }
+        records.push_back(record);
+    }
+
+    SensorsStore store;
+    CHECK(store.open(directory.c_str(), 4096));
+    CHECK(store.append(&records[0], records.size()) == records.size());
+    CHECK(store.getColumns() == 3);
+    checkScans(&store, records);
+    CHECK(store.flush());
+    CHECK(store.getSegments() > 1);
+    checkScans(&store, records);
+    store.close();
+
+    // Blocks after a reopen go to a new segment
+    CHECK(store.open(directory.c_str(), 4096));
+    CHECK(store.getPoints() == records.size());
+    checkScans(&store, records);
+    SensorsRecord late = { 2, 500, -4000, XBEE_TEMPERATURE_HEADER | 0x01, 0, 0, 0 };
+    size_t segments = store.getSegments();
+    CHECK(store.append(late));
+    records.push_back(late);
+    store.close();
+    CHECK(store.open(directory.c_str(), 4096));
+    CHECK(store.getSegments() == segments + 1);
+    checkScans(&store, records);
+    std::vector<int64_t> times;
+    std::vector<int32_t> values;
+    CHECK(store.scan(9, XBEE_TEMPERATURE_HEADER | 0x01, INT64_MIN, INT64_MAX, &times, &values) == 0);
+    store.close();
+    removeDirectory(directory);
+}
+
+int main()
+{
+    testDecoder();
+    testStore();
+
+    if (failures == 0) {
+        printf("SensorsStoreTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,91 @@
+//
+//  SensorsXBeeTest
+//  Host test
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Record packing into buffers that are too small for one snapshot:
+//  request replies resume, completion is reported and nothing is
+//  skipped.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define private public
+#include <Sensors.h>
+#undef private
+
+JRTC RTC;
+
+void reset() {}
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    if (!(condition)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static void run(Sensors *sensors, uint8_t ticks)
+{
+    for (uint8_t i = 0; i < ticks; i++) {
+        hostMicros += (SENSORS_LOOP_CHECK + 1) * 1000UL;
+        sensors->loop();
+    }
+}
+
+int main()
+{
+    Sensors sensors;
+    sensors.setup();
+    run(&sensors, 8);
+
+    const uint8_t request[3] = { XBEE_REQUEST_HEADER, 0xFF, 0xFF };
+    ByteBuffer buffer;
+    buffer.init(256);
+    uint8_t all = sensors.putXBeeRequest(request, sizeof(request), &buffer);
+    CHECK(all > 2);
+    CHECK(sensors.isXBeeComplete());
+
+    // The same request continues where the last reply stopped, each
+    // continuation starts with the time again
+    uint8_t records = 0;
+    uint8_t replies = 0;
+    do {
+        buffer.init(XBEE_TIME_RECORD_SIZE + 2 * XBEE_LONG_RECORD_SIZE);
+        records += sensors.putXBeeRequest(request, sizeof(request), &buffer);
+        replies++;
+    } while (!sensors.isXBeeComplete() && replies < 20);
+    CHECK(replies > 1);
+    CHECK(records - (replies - 1) == all);
+
+    // Not even the first record fits: nothing written, not complete
+    buffer.init(3);
+    CHECK(sensors.putXBeeData(&buffer) == 0);
+    CHECK(!sensors.isXBeeComplete());
+    buffer.init(256);
+    CHECK(sensors.putXBeeData(&buffer) > 0);
+    CHECK(sensors.isXBeeComplete());
+
+    // Duplicates in the priority must not push a channel out
+    const uint8_t priority[4] = { 3, 3, 9, 3 };
+    sensors.setXBeePriority(priority, sizeof(priority));
+    buffer.init(256);
+    CHECK(sensors.putXBeeRequest(request, sizeof(request), &buffer) == all);
+    for (uint8_t i = 0; i < SENSORS_CHANNELS; i++) {
+        uint8_t count = 0;
+        for (uint8_t j = 0; j < SENSORS_CHANNELS; j++) {
+            count += sensors._priority[j] == i;
+        }
+        CHECK(count == 1);
+    }
+
+    const uint8_t invalid[3] = { 0x00, 0xFF, 0xFF };
+    CHECK(sensors.putXBeeRequest(invalid, sizeof(invalid), &buffer) == 0);
+
+    if (failures == 0) {
+        printf("SensorsXBeeTest ok\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,44 @@
+//
+//  Arduino
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#include <Arduino.h>
+
+unsigned long hostMicros = 0;
+uint8_t hostSda = HIGH;
+bool hostTimeSet = true;
+HardwareSerial Serial;
+
+unsigned long millis()
+{
+    return hostMicros / 1000;
+}
+
+unsigned long micros()
+{
+    return hostMicros;
+}
+
+void delay(unsigned long ms)
+{
+    hostMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    hostMicros += us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+int digitalRead(uint8_t pin) { return pin == SDA ? hostSda : HIGH; }
+int digitalPinToInterrupt(uint8_t pin) { return pin == 2 ? 0 : NOT_AN_INTERRUPT; }
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {}
+void detachInterrupt(uint8_t interrupt) {}
+void noInterrupts() {}
+void interrupts() {}
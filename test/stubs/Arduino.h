@@ -0,0 +1,82 @@
+//
+//  Arduino
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  Just enough of the Arduino core to build the drivers on the host.
+//  Time is simulated, hostMicros is advanced by the tests.
+//
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define HIGH                1
+#define LOW                 0
+#define INPUT               0
+#define OUTPUT              1
+#define INPUT_PULLUP        2
+#define FALLING             2
+#define NOT_AN_INTERRUPT    -1
+
+#define bitRead(value, bit)             (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)              ((value) |= (1UL << (bit)))
+#define bitClear(value, bit)            ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue)  ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+static const uint8_t SDA = 18;
+static const uint8_t SCL = 19;
+
+#define min(a, b)                       ((a) < (b) ? (a) : (b))
+#define max(a, b)                       ((a) > (b) ? (a) : (b))
+
+extern unsigned long hostMicros;
+extern uint8_t hostSda;             // Level a device drives on SDA
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+class String
+{
+public:
+    String(const char *value = "") {}
+    template <class T> String &operator+=(T value) { return *this; }
+    template <class T> void concat(T value) {}
+};
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baud) {}
+    int availableForWrite() { return 64; }
+    size_t write(uint8_t value) { return 1; }
+    size_t write(const uint8_t *data, size_t length) { return length; }
+    template <class T> size_t print(T value) { return 0; }
+    template <class T> size_t println(T value) { return 0; }
+    size_t println() { return 0; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,35 @@
+//
+//  ByteBuffer
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#ifndef ByteBuffer_h
+#define ByteBuffer_h
+
+#include <Arduino.h>
+
+class ByteBuffer
+{
+public:
+    void init(unsigned int capacity) { _capacity = capacity; _size = 0; }
+    unsigned int getSize() { return _size; }
+    unsigned int getFreeSize() { return _capacity - _size; }
+    unsigned int getCapacity() { return _capacity; }
+    void clear() { _size = 0; }
+    int put(byte value) { return add(1); }
+    int putInt(int value) { return add(sizeof(int)); }
+    int putLong(long value) { return add(sizeof(long)); }
+    int putTime(time_t value) { return add(sizeof(time_t)); }
+
+private:
+    unsigned int    _capacity   =   0;
+    unsigned int    _size       =   0;
+
+    int add(unsigned int length) { if (_size + length > _capacity) return 0; _size += length; return 1; }
+};
+
+#endif
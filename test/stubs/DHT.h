@@ -0,0 +1,26 @@
+//
+//  DHT
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#ifndef DHT_h
+#define DHT_h
+
+#include <Arduino.h>
+
+#define DHT22 22
+
+class DHT
+{
+public:
+    DHT(uint8_t pin, uint8_t type) {}
+    void begin() {}
+    float readTemperature() { return 21.5; }
+    float readHumidity() { return 55.0; }
+};
+
+#endif
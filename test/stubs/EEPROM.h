@@ -0,0 +1,35 @@
+//
+//  EEPROM
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  1 kB like an Uno, the writes are counted for the wear checks.
+//
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <Arduino.h>
+
+#define EEPROM_SIZE     1024
+
+class EEPROMClass
+{
+public:
+    EEPROMClass() { memset(_data, 0xFF, sizeof(_data)); }
+
+    uint8_t read(int address) { return _data[address]; }
+    void write(int address, uint8_t value) { _data[address] = value; _writes++; }
+    unsigned long getWrites() { return _writes; }
+
+private:
+    uint8_t         _data[EEPROM_SIZE];
+    unsigned long   _writes     =   0;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,24 @@
+//
+//  JRTC
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#ifndef JRTC_h
+#define JRTC_h
+
+#include <Time.h>
+
+class JRTC
+{
+public:
+    static time_t get() { return now(); }
+    int temperature() { return 2150; }
+};
+
+extern JRTC RTC;
+
+#endif
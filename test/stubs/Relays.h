@@ -0,0 +1,24 @@
+//
+//  Relays
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#ifndef Relays_h
+#define Relays_h
+
+#include <Arduino.h>
+
+class Relays
+{
+public:
+    bool isSetup() { return false; }
+    void setTemperature(float value) {}
+    void setHumidity(float value) {}
+    void setLight(uint16_t value) {}
+};
+
+#endif
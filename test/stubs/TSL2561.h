@@ -0,0 +1,28 @@
+//
+//  TSL2561
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#ifndef TSL2561_h
+#define TSL2561_h
+
+#include <Arduino.h>
+
+#define TSL2561_ADDR_FLOAT              0x39
+#define TSL2561_INTEGRATIONTIME_13MS    0
+
+class TSL2561
+{
+public:
+    TSL2561(uint8_t address) {}
+    bool begin() { return true; }
+    uint32_t getFullLuminosity() { return 0x00400100; }
+    void setTiming(int timing) {}
+    uint32_t calculateLux(uint16_t full, uint16_t ir) { return 250; }
+};
+
+#endif
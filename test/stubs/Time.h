@@ -0,0 +1,31 @@
+//
+//  Time
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+
+#ifndef Time_h
+#define Time_h
+
+#include <Arduino.h>
+
+typedef time_t (*getExternalTime)();
+enum timeStatus_t { timeNotSet, timeNeedsSync, timeSet };
+
+extern bool hostTimeSet;
+
+inline void setSyncProvider(getExternalTime provider) {}
+inline timeStatus_t timeStatus() { return hostTimeSet ? timeSet : timeNotSet; }
+inline time_t now() { return 1572048000 + millis() / 1000; }
+inline int weekday(time_t t) { return 1; }
+inline int hour(time_t t) { return 0; }
+inline int minute(time_t t) { return 0; }
+inline int second(time_t t) { return 0; }
+inline int day(time_t t) { return 1; }
+inline int month(time_t t) { return 1; }
+inline int year(time_t t) { return 2019; }
+
+#endif
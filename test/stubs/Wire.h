@@ -0,0 +1,53 @@
+//
+//  Wire
+//  Host stub for the tests
+//  ----------------------------------
+//
+//  Sensors
+//  Created by jeroenjonkman on 19-10-26
+//
+//  A fake bus with one BMP180. hostWireHang makes every transaction
+//  run into the timeout, like a device holding the bus, hostWireAbsent
+//  makes the BMP180 stop answering.
+//
+
+#ifndef Wire_h
+#define Wire_h
+
+#include <Arduino.h>
+
+#define WIRE_HAS_END
+#define WIRE_HAS_TIMEOUT
+
+extern bool hostWireHang;
+extern bool hostWireAbsent;
+extern uint32_t hostWireTimeout;
+
+class TwoWire
+{
+public:
+    void begin();
+    void end();
+    void setWireTimeout(uint32_t timeout, bool reset);
+    bool getWireTimeoutFlag();
+    void clearWireTimeoutFlag();
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    uint8_t endTransmission();
+    uint8_t requestFrom(uint8_t address, uint8_t length);
+    int available();
+    int read();
+
+private:
+    uint8_t     _register   =   0;
+    bool        _pointer    =   false;
+    bool        _timeout    =   false;
+    uint8_t     _read       =   0;
+    uint8_t     _length     =   0;
+
+    bool        hang();
+};
+
+extern TwoWire Wire;
+
+#endif